@@ -14,6 +14,9 @@
 #define DAA_HPP
 
 #include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <climits>
 
 namespace Daa
 {
@@ -38,7 +41,8 @@ namespace Daa
  *     program termination).  do not free on the function return pointer since
  *     array storage begins with the data and is followed by ptrs to ptrs to
  *     ..., and the first element(lowest subscript of each dimension), does
- *     not point to the beginning of allocated space.  the array is initialized
+ *     not point to the beginning of allocated space(see DAA_PTRS_FIRST in
+ *     daa_layout for a layout where it does).  the array is initialized
  *     to the value pointed to by the last parameter, or not initialized if
  *     NULL.  the last parameter init pointer should point to something with a
  *     size the same as the size of the type in the sizeof() first argument.
@@ -63,12 +67,23 @@ namespace Daa
  *        alignment.  the pointer area comes second and may, depending on the
  *        total size of the data area, need to be aligned on a sizeof(char *)
  *        boundary.  the beginning of the  pointer area is tested for
- *        alignment, and its alignment adjusted if necessary.
+ *        alignment, and its alignment adjusted if necessary.  with
+ *        DAA_PTRS_FIRST the order is reversed and the data area follows the
+ *        pointer area, aligned to the layout align.
+ *        a daa_layout with a non-zero align aligns the data area, and with
+ *        DAA_PAD_ROWS each innermost row, to align bytes regardless of the
+ *        allocation routine.  daa_alloc() allocates aligned space.
  *
  *     3. for an excellent reference on this type of array access see Numerical
  *        Recipes in C, Press, Flannery, Teukolsky, and Vettering, Cambridge
  *        University Press, 1992, pg. 20.
  *
+ *     4. a slice like array[-1] passes a leading part of an array to a
+ *        subroutine.  for any other part, a box, every other plane or the
+ *        array with other start subscripts, dad_sub() makes a descriptor
+ *        of the part and daa_sub() a new pointer table over the same data,
+ *        nothing is copied.
+ *
  * Author:
  *    Richard Hogaboom
  *    richard.hogaboom@gmail.com
@@ -80,11 +95,25 @@ namespace Daa
 
 /* global constants */
 const unsigned int MAX_DIM = 256; /* maximum number of array dimensions */
+const size_t FILL_BLOCK = 4096;   /* data_fill() replication block size in bytes */
+const size_t WIDE_FILL = 16;      /* data_fill() store width in bytes */
+const size_t ARENA_ALIGN = 16;    /* daa_arena block alignment and header bytes */
 
 /* error msg indices */
 const unsigned int ERRS_INV_DIMS = 0;
 const unsigned int ERRS_INV_REQ_SIZE = 1;
 const unsigned int ERRS_INV_DIM = 2;
+const unsigned int ERRS_SIZE_OVERFLOW = 3;
+const unsigned int ERRS_NO_MEM = 4;
+const unsigned int ERRS_OFF32_RANGE = 5;
+const unsigned int ERRS_INV_ALIGN = 6;
+const unsigned int ERRS_NOT_REL = 7;
+const unsigned int ERRS_SYS = 8;
+const unsigned int ERRS_CAPACITY = 9;
+const unsigned int ERRS_VIEW_BOX = 10;
+const unsigned int ERRS_VIEW_STEP = 11;
+const unsigned int ERRS_FILE = 12;
+const unsigned int ERRS_SUBSCRIPT = 13;
 
 /* error msgs */
 const char *daa_errs[] =
@@ -92,249 +121,175 @@ const char *daa_errs[] =
     "daa: invalid number of dimensions - must be > 0 and <= MAX_DIM.",
     "daa: invalid request size - must be > 0.",
     "daa: invalid dimension - must be > 0.",
+    "daa: array size overflow - size exceeds the range of the size type.",
+    "daa: memory allocation failed.",
+    "daa: 32 bit offset range exceeded - DAA_OFF32 blocks must be <= 4 GiB.",
+    "daa: invalid alignment - must be 0 or a power of 2.",
+    "daa: layout not position independent - must be DAA_OFF32 or DAA_REL.",
+    "daa: system call failed - see errno.",
+    "daa: capacity exceeded - dimension 0 must be > 0 and <= the layout cap0.",
+    "daa: invalid view - steps must be != 0 and the view within the array.",
+    "daa: invalid view step - the last dimension step of a pointer view must be 1.",
+    "daa: invalid file - not a file of the array, too short or corrupt.",
+    "daa: subscript out of range - must be within the dimension.",
 };
 
+/* 32 bit unsigned type of the DAA_OFF32 offset tables */
+#if UINT_MAX >= 0xffffffffUL
+typedef unsigned int daa_u32;
+#else
+typedef unsigned long daa_u32;
+#endif
+
+/* layout flags */
+const unsigned int DAA_NO_PTRS = 0x1; /* data area only, no pointer arrays, see dad() */
+const unsigned int DAA_OFF32 = 0x2;   /* 32 bit offset tables, see daa_off() */
+const unsigned int DAA_PAD_ROWS = 0x4; /* pad the innermost rows to multiples of align */
+const unsigned int DAA_REL = 0x8;      /* base relative, position independent tables */
+const unsigned int DAA_PTRS_FIRST = 0x10; /* pointer area first, then the data area */
+const unsigned int DAA_ZEROED = 0x20;  /* the space is zero filled, skip a zero init */
+
 /*
- * doff:
- *     data offset routine that calculates the offset in basic data
- *     units of the location of the data item specified by the
- *     current settings in dim_ind[].  this multiplied by the size of
- *     a basic data unit plus the offset of the start of the area
- *     gives the address of the data item.  a basic data unit may be
- *     either a pointer(sizeof(char *) bytes long) or array data
- *     item(data_size bytes long).
+ * daa_layout:
+ *     layout options for the das()/daa()/dad() versions that take one.  a
+ *     NULL layout, or all members zero, is the default daa() layout, the
+ *     data area followed by the sizeof(char *) aligned pointer area.
  *
- * Arguments:
- *     unsigned int level
- *        the array level to initialize pointers for.  the first
- *        dimension is level 0, the second level 1, etc., always
- *        starts at zero.
+ *     a non-zero align aligns the start of the data area to align bytes,
+ *     whatever the alignment of the space given to daa().  with
+ *     DAA_PAD_ROWS the byte length(pitch) of each innermost row is also
+ *     rounded up to a multiple of align, so every row starts aligned and
+ *     the pointers of the last level point at aligned rows.  the padding
+ *     bytes are not initialized.
  *
- *     int *dim_ind
- *        dimension index array of current call, starts zeroed.
+ *     DAA_PTRS_FIRST puts the pointer area first, every level contiguous
+ *     from the top level down, and the data area after it, aligned to
+ *     align.  the pointers are then together at the start of the block,
+ *     not after the data, and for a start of the block aligned to
+ *     sizeof(char *) and st[0] of 0 the pointer daa() returns is the
+ *     start of the block, the pointer to give to free().
  *
- *     int dim_prod
- *        product of dimensions from zero to level.
+ *     DAA_OFF32 and DAA_REL tables hold offsets from the block base, not
+ *     pointers, and the parts of the block are at fixed offsets from the
+ *     base(the data area, or with DAA_PTRS_FIRST the tables, at 0), so
+ *     the block is position independent.
+ *     it can be copied, mapped at another address or shared between
+ *     processes as it is, see daa_attach().  the space given to daa() for
+ *     these layouts must be aligned to align and to the table entry size.
  *
- *     unsigned int *dp
- *        array of dimension products.
+ *     DAA_ZEROED tells daa() that the space given to it is already zero
+ *     filled, as fresh calloc() or mmap() memory is.  an init value whose
+ *     bytes are all zero is then not written, only the pointer area is,
+ *     so the data pages are not touched until they are used.  the layout
+ *     flag is a promise about the space, daa() does not check it.
  *
- * Returns:
- *     int offset in basic data units from the start of the data area(base_ptr)
- *     to data item specified by dim_ind[].  byte offset is given by:
- *     doff(level, dim_ind, dim_prod, dp) * data_size.
+ *     a cap0 larger than dim[0] sizes the block, and builds the pointers,
+ *     for cap0 elements of dimension 0, so dimension 0 can later grow to
+ *     cap0 with daa_grow() without moving or rebuilding anything.  the
+ *     data is row major, so the rows of dimension 0 beyond dim[0] are at
+ *     the end of the data area.
  */
 
-    static int
-doff(
-    unsigned int level,
-    int *dim_ind,
-    int dim_prod,
-    unsigned int *dp)
+struct daa_layout
 {
-    if ( level == 0 )
-    {
-        return 0;
-    }
-    else
-    {
-        return doff(level-1, dim_ind, dim_prod, dp) +
-            (dim_prod/dp[level-1]) * dim_ind[level-1];
-    }
-}
+    unsigned int flags;  /* DAA_* layout flags */
+    size_t align;        /* data alignment in bytes, 0 or a power of 2 */
+    size_t cap0;         /* capacity of dimension 0, 0 for dim[0] */
+};
 
+/* page kinds of the space of a block, see daa_stats */
+const int DAA_PAGE_UNKNOWN = 0;  /* space allocated by the caller */
+const int DAA_PAGE_HUGETLB = 1;  /* explicit huge pages, MAP_HUGETLB */
+const int DAA_PAGE_THP = 2;      /* transparent huge pages, MADV_HUGEPAGE */
+const int DAA_PAGE_NORMAL = 3;   /* normal pages */
 
 /*
- * off:
- *     offset routine that calculates the offset in pointer units(char *)
- *     of the start of the pointer array for that level.  each level has a
- *     pointer array associated with that level that points to the next level
- *     and is pointed to by the previous level.
- *
- * Arguments:
- *     unsigned int level
- *        the array level to initialize pointers for.  the first dimension is
- *        level 0, the second level 1, etc., always starts at zero.
- *
- *     unsigned int *dp
- *        array of dimension products.
- *
- * Returns:
- *     int offset in pointer units(char *) of the pointer array for that level.
- *     byte offset is given by off(level, dp) * sizeof(char *).
+ * daa_stats:
+ *     the space used by each part of a block, filled in by das().  the
+ *     overhead of a layout over the bare data is size - data_bytes.
+ *     das() sets page_kind to DAA_PAGE_UNKNOWN, the allocation helpers
+ *     of daa_mmap.hpp set the kind of page they obtained.
  */
 
-    static int
-off(
-    unsigned int level,
-    unsigned int *dp)
+struct daa_stats
 {
-    if ( level == 0 )
-    {
-        return 0;
-    }
-    else
-    {
-        return dp[level-1] + off(level-1, dp);
-    }
-}
-
+    size_t data_bytes;  /* the array elements */
+    size_t ptr_bytes;   /* the pointer or offset tables */
+    size_t pad_bytes;   /* row padding and alignment slack */
+    size_t size;        /* total, the das() size */
+    int page_kind;      /* DAA_PAGE_* kind of page of the space */
+};
 
 /*
- * ptr_init:
- *     this routine uses the space pointed to by the "base_ptr" pointer.
- *     it constructs the several levels of pointers needed to reference
- *     elements of a multidimensional array.
- *
- * Arguments:
- *     unsigned int level
- *        the array level to initialize pointers for.  the first dimension
- *        is level 0, the second level 1, etc., always starts at zero.
- *
- *     int *dim_ind
- *        dimension index array of current call, starts zeroed.
- *
- *     unsigned int data_size
- *        size of the basic array data object.  this will usually be
- *        obtained from the sizeof() function.
- *
- *     unsigned int num_dim
- *        number of array dimensions.
- *
- *     char *data_ptr
- *        points to base of allocated array.
- *
- *     char *ptr_ptr
- *        points to base of pointers to pointers to ... to data
- *
- *     unsigned int *dim
- *        a single dimensional int array of the dimensions of the array to
- *        be allocated.
- *
- *     int *st
- *        a single dimensional int array of integer start subscripts for
- *        each corresponding dimension of the dim array, elements may
- *        be negative.
- *
- *     unsigned int *dp
- *        array of dimension products.
- *
- * Returns:
- *     pointer to next level of indirection.
+ * daa_desc:
+ *     array descriptor(dope vector) filled in by dad().  the address of
+ *     array[i0][i1]...[in-1] is origin + i0*stride[0] + ... +
+ *     in-1*stride[n-1], see daa_at().  no pointer arrays are used.
  */
 
-    static char *
-ptr_init(
-    unsigned int level,
-    int *dim_ind,
-    unsigned int data_size,
-    unsigned int num_dim,
-    char *data_ptr,
-    char *ptr_ptr,
-    unsigned int *dim,
-    int *st,
-    unsigned int *dp)
+struct daa_desc
 {
-    char		**ptrs;
-    unsigned long	i;
-
-
-    /*
-     * if level is not final level get pointer to array of pointers
-     * for that level and recursively call ptr_init() to return pointers to
-     * fill the array of pointers.  if level is final level calculate
-     * position of data and return pointer to level-1.
-     */
-
-    if ( level < (num_dim - 1) )
-    {
-        /*
-         * ptrs points to the start of a subarray of pointers to the
-         * next dimension level of pointers or data
-         */
-
-        ptrs = (char **) (ptr_ptr + off(level, dp) * sizeof(char *) +
-            ((level == 0)?0:doff(level, dim_ind,
-            dp[level], dp) * sizeof(char *)));
-
-        /* fill the array of pointers that ptrs points to */
-        for ( i = 0 ; i < dim[level] ; i++ )
-        {
-            dim_ind[level] = i;
-
-            /*
-             * the recursive call to ptr_init() returns a pointer to the
-             * next level and is then adjusted by st[] for a
-             * non-zero based subscript
-             */
-
-            ptrs[i] = ptr_init(level+1, dim_ind, data_size, num_dim, data_ptr,
-                ptr_ptr, dim, st, dp) - st[level+1] *
-                ((level+1 == num_dim-1)?data_size:sizeof(char *));
-        }
-
-        /*
-         * adjust zeroth level pointer that is passed back to root
-         * of recursive tree call
-         */
-
-        if ( level == 0 )
-        {
-            ptrs -= st[0];
-        }
-    }
-    else
-    {
-        /*
-         * calculate pointers to data subarrays.  if one dimensional
-         * array and non-zero subscripting adjust returned pointer
-         */
+    char *data;                 /* start of the data area */
+    char *origin;               /* address of the all zero subscripts element */
+    size_t data_size;           /* size of the basic array data object */
+    unsigned int num_dim;       /* number of array dimensions */
+    size_t dim[MAX_DIM];        /* dimensions */
+    ptrdiff_t st[MAX_DIM];      /* start subscripts */
+    ptrdiff_t stride[MAX_DIM];  /* byte stride of each dimension */
+};
 
-        ptrs = (char **) (data_ptr + doff(level, dim_ind, dp[level], dp) *
-            data_size - ((level == 0)?(st[0] * data_size):0));
-    }
+/*
+ * daa_view:
+ *     a view of a DAA_OFF32 or DAA_REL block at the address it is mapped
+ *     at in this process, filled in by daa_attach().  it holds only the
+ *     base and offsets, see daa_view_at().
+ */
 
-    return (char *) ptrs;
-}
+struct daa_view
+{
+    char *base;             /* the block base in this process */
+    size_t top;             /* offset of the zeroth level, adjusted by st[0] */
+    size_t data_size;       /* size of the basic array data object */
+    unsigned int num_dim;   /* number of array dimensions */
+    unsigned int flags;     /* DAA_OFF32 or DAA_REL */
+};
 
 /*
- * das:
- *     dynamic array size.  this routine takes four of the same arguments
- *     that daa() takes and calculates the total space allocation in bytes
- *     required to store the array.  normally used in conjunction with
- *     daa() to do a das()/malloc()/daa() sequence.
+ * dim_prod:
+ *     validate the array shape arguments and calculate the dimension
+ *     products dp[], dp[i] = dim[0]*dim[1]*...*dim[i].  every product is
+ *     checked for overflow of size_t.
  *
  * Arguments:
- *     unsigned int data_size
- *        size of the basic array data object.  this will usually be
- *        obtained from the sizeof() function.
+ *     size_t data_size
+ *        size of the basic array data object.
  *
  *     unsigned int num_dim
  *        number of array dimensions.
  *
- *     unsigned int *dim
- *        a single dimensional int array of the dimensions of the array to
- *        be allocated.
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array.
+ *
+ *     size_t *dp
+ *        returned array of dimension products, num_dim elements.
  *
  *     int *err_code
  *        index to returned error code string in daa_errs[].
  *
  * Returns:
- *     size in bytes of dynamic array that daa() will use.
+ *     0 on success, -1 on failure with *err_code set.
  */
 
-    inline int
-das(
-    unsigned int data_size,
+    static int
+dim_prod(
+    size_t data_size,
     unsigned int num_dim,
-    unsigned int *dim,
+    size_t *dim,
+    size_t *dp,
     int *err_code)
 {
     unsigned int i;
 
-    /* product of dimensions from 0 to index, dim[0]*dim[1]...dim[index] */
-    unsigned int dp[MAX_DIM];
-
 
     if ( num_dim < 1 || num_dim > MAX_DIM )
     {
@@ -348,170 +303,2792 @@ das(
         return -1;
     }
 
-    dp[0] = dim[0];
     for ( i = 0 ; i < num_dim ; i++ )
     {
-        if ( dim[i] <= 0 )
+        if ( dim[i] == 0 )
         {
             *err_code = ERRS_INV_DIM;
             return -1;
         }
 
-        if ( i > 0 )
+        if ( i == 0 )
+        {
+            dp[i] = dim[i];
+        }
+        else
         {
+            if ( dp[i-1] > ((size_t) -1) / dim[i] )
+            {
+                *err_code = ERRS_SIZE_OVERFLOW;
+                return -1;
+            }
             dp[i] = dp[i-1] * dim[i];
         }
     }
 
-    return(dp[num_dim-1] * data_size + off(num_dim-1, dp) * sizeof(char *) +
-        sizeof(char *));
+    return 0;
 }
 
 /*
- * daa:
- *     dynamic array allocator
+ * daa_geom:
+ *     the geometry of an array block, calculated by geom().
+ */
+
+struct daa_geom
+{
+    size_t dp[MAX_DIM];  /* dimension products */
+    unsigned int flags;  /* DAA_* layout flags */
+    int rel;             /* base relative layout, parts at fixed offsets */
+    size_t align;        /* data area alignment, >= 1 */
+    size_t pitch;        /* byte length of an innermost row, with padding */
+    size_t data_bytes;   /* byte size of the data area, with row padding */
+    size_t ptr_count;    /* number of entries in the pointer area */
+    size_t entry_size;   /* byte size of a pointer area entry */
+    size_t ptr_bytes;    /* byte size of the pointer area entries */
+    size_t pad_bytes;    /* data and pointer area alignment slack */
+    size_t size;         /* das() size of the block */
+};
+
+/*
+ * geom:
+ *     validate the array shape and layout and calculate the geometry of
+ *     the block, checking every size for overflow.
  *
  * Arguments:
- *     unsigned int data_size
- *        size of the basic array data object.  this will usually be
- *        obtained from the sizeof() function.
+ *     size_t data_size
+ *        size of the basic array data object.
  *
  *     unsigned int num_dim
  *        number of array dimensions.
  *
- *     unsigned int *dim
- *        a single dimensional int array of the dimensions of the array to
- *        be allocated.
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array.
  *
- *     int *st
- *        a single dimensional int array of integer start subscripts for
- *        each corresponding dimension of the dim array, elements may
- *        be negative.
+ *     const daa_layout *layout
+ *        layout options, or NULL for the default layout.
+ *
+ *     daa_geom *g
+ *        returned geometry.
  *
  *     int *err_code
  *        index to returned error code string in daa_errs[].
  *
- *     char *base_ptr
- *        pointer to the array space.
- *
- *     char *init_ptr
- *        initialization pointer parameter.
- *
  * Returns:
- *     error free operation returns a pointer to void that points to the start
- *     of the dynamically allocated array area and does not set *err_code.  the
- *     returned pointer will need to be cast to the type of the subsequent array
- *     references.
- *
- *     routine failure returns NULL and any of the following
- *     error codes in *err_code:
- *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
- *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
- *     ERRS_INV_DIM - invalid dimension - must be > 0.
- *
- *     failure to index the subscripts in the manner established by the starting
- *     index and the dimensional extent will of course result in run time errors.
- *     this is not an array allocation error but an array usage error, similar
- *     to any array access on a static C zero based array outside the normal
- *     0...n-1 bounds.
+ *     0 on success, -1 on failure with *err_code set.
  */
 
-    inline void *
-daa(
-    unsigned int data_size,
+    static int
+geom(
+    size_t data_size,
     unsigned int num_dim,
-    unsigned int *dim,
-    int *st,
-    int *err_code,
-    char *base_ptr,
-    char *init_ptr)
+    size_t *dim,
+    const daa_layout *layout,
+    daa_geom *g,
+    int *err_code)
 {
-    unsigned int i, j;
-
-    /* array of current dimension indices */
-    int	dim_ind[MAX_DIM];
-
-    char *p_data, /* pointer to array data */
-         *p;      /* tmp pointer */
-
-    /* product of dimensions from 0 to index, dim[0]*dim[1]...dim[index] */
-    unsigned int dp[MAX_DIM];
+    unsigned int i;
+    unsigned int flags = (layout != NULL) ? layout->flags : 0;
+    size_t rows;  /* number of innermost rows */
 
-    /* points to base of pointers to pointers to ... to data */
-    char *ptr_ptr;
 
+    if ( dim_prod(data_size, num_dim, dim, g->dp, err_code) < 0 )
+    {
+        return -1;
+    }
 
-    if ( num_dim < 1 || num_dim > MAX_DIM )
+    /* the block is sized for the dimension 0 capacity */
+    if ( layout != NULL && layout->cap0 > dim[0] )
     {
-        *err_code = ERRS_INV_DIMS;
-        return NULL;
+        for ( i = 0 ; i < num_dim ; i++ )
+        {
+            if ( g->dp[i] / dim[0] > ((size_t) -1) / layout->cap0 )
+            {
+                *err_code = ERRS_SIZE_OVERFLOW;
+                return -1;
+            }
+            g->dp[i] = g->dp[i] / dim[0] * layout->cap0;
+        }
     }
 
-    if ( data_size < 1 )
+    g->flags = flags;
+    g->align = (layout != NULL && layout->align > 0) ? layout->align : 1;
+    if ( (g->align & (g->align - 1)) != 0 )
     {
-        *err_code = ERRS_INV_REQ_SIZE;
-        return NULL;
+        *err_code = ERRS_INV_ALIGN;
+        return -1;
     }
 
-    /*
-     * set dim_ind to all zeros, the multiple invocations of the recursive
-     * array allocation routine ptr_init() will pass changed by 1 dim_ind arrays
-     * to each invocation of ptr_init().  set dp[] from dim[] input array.
-     */
+    if ( g->dp[num_dim-1] > ((size_t) -1) / data_size )
+    {
+        *err_code = ERRS_SIZE_OVERFLOW;
+        return -1;
+    }
+    g->data_bytes = g->dp[num_dim-1] * data_size;
+    g->pitch = dim[num_dim-1] * data_size;
 
-    dp[0] = dim[0];
-    for ( i = 0 ; i < num_dim ; i++ )
+    /* round the innermost rows up to a multiple of the alignment */
+    if ( (flags & DAA_PAD_ROWS) && num_dim > 1 )
     {
-        dim_ind[i] = 0;
-        if ( dim[i] <= 0 )
+        rows = g->dp[num_dim-2];
+        if ( g->pitch > ((size_t) -1) - (g->align - 1) )
         {
-            *err_code = ERRS_INV_DIM;
-            return NULL;
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return -1;
         }
-
-        if ( i > 0 )
+        g->pitch = (g->pitch + g->align - 1) & ~(g->align - 1);
+        if ( rows > ((size_t) -1) / g->pitch )
         {
-            dp[i] = dp[i-1] * dim[i];
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return -1;
         }
+        g->data_bytes = rows * g->pitch;
     }
 
-    /*
-     * calculate address of start of pointers.  If not
-     * sizeof(char *) aligned make it so.
-     */
-    ptr_ptr = base_ptr + dp[num_dim-1] * data_size;
+    g->rel = (flags & DAA_NO_PTRS) == 0 && (flags & (DAA_OFF32 | DAA_REL)) != 0;
+    g->ptr_count = 0;
+    g->entry_size = (flags & DAA_OFF32) ? sizeof(daa_u32) :
+        (flags & DAA_REL) ? sizeof(size_t) : sizeof(char *);
+    g->ptr_bytes = 0;
 
-    for ( i = 0 ; i < sizeof(char *) ; i++, ++ptr_ptr )
+    /* a base relative block starts aligned, others may need slack */
+    g->pad_bytes = g->rel ? 0 : g->align - 1;
+    if ( (flags & DAA_NO_PTRS) == 0 )
     {
-        if ( ((unsigned long)ptr_ptr)%sizeof(char *) == 0 )
+        for ( i = 0 ; i < num_dim - 1 ; i++ )
         {
-            break;
+            if ( g->ptr_count > ((size_t) -1) - g->dp[i] )
+            {
+                *err_code = ERRS_SIZE_OVERFLOW;
+                return -1;
+            }
+            g->ptr_count += g->dp[i];
         }
-    }
 
-    /* if init_ptr is NULL skip initialization */
-    if ( init_ptr != NULL )
-    {
-        /* set p_data to point to the start of the data area */
-        p_data = base_ptr;
-     
-        /* initialize the array */
-        for ( i = 0 ; i < dp[num_dim-1] ; i++ )
+        /* entries plus one for the pointer area alignment slack(or padding) */
+        if ( g->ptr_count > ((size_t) -1) / g->entry_size - 1 )
         {
-            p = init_ptr;
-            for ( j = 0 ; j < data_size ; j++ )
-            {
-                *p_data++ = *p++;
-            }
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return -1;
+        }
+        g->ptr_bytes = g->ptr_count * g->entry_size;
+        if ( !g->rel )
+        {
+            g->pad_bytes += g->entry_size;
+        }
+        else if ( flags & DAA_PTRS_FIRST )
+        {
+            g->pad_bytes += (g->align - g->ptr_bytes % g->align) % g->align;
+        }
+        else
+        {
+            g->pad_bytes += (g->entry_size - g->data_bytes % g->entry_size) %
+                g->entry_size;
         }
     }
 
-    /* do array setup i.e. all the pointer stuff */
-    return ptr_init(0, dim_ind, data_size, num_dim, base_ptr,
-        ptr_ptr, dim, st, dp);
+    if ( g->data_bytes > ((size_t) -1) - g->ptr_bytes - g->pad_bytes )
+    {
+        *err_code = ERRS_SIZE_OVERFLOW;
+        return -1;
+    }
+    g->size = g->data_bytes + g->ptr_bytes + g->pad_bytes;
+
+    /* every offset must be below the end of the block */
+    if ( (flags & (DAA_OFF32 | DAA_NO_PTRS)) == DAA_OFF32 &&
+        g->size - 1 > (daa_u32) -1 )
+    {
+        *err_code = ERRS_OFF32_RANGE;
+        return -1;
+    }
+
+    return 0;
 }
 
-} // daa namespace
+/*
+ * align_ptr:
+ *     the first align aligned address at or after p.
+ *
+ * Arguments:
+ *     char *p
+ *        address to align.
+ *
+ *     size_t align
+ *        alignment, a power of 2.
+ *
+ * Returns:
+ *     the aligned address.
+ */
 
-#endif  // DAA_HPP
+    static char *
+align_ptr(
+    char *p,
+    size_t align)
+{
+    return p + ((align - (size_t) p % align) % align);
+}
+
+/*
+ * blk_place:
+ *     the addresses of the data area and the pointer area of a block with
+ *     geometry g in the space pointed to by base_ptr.  the parts of a base
+ *     relative block are at fixed offsets, the base is aligned.  with
+ *     DAA_PTRS_FIRST the pointer area comes first.
+ *
+ * Arguments:
+ *     char *base_ptr
+ *        pointer to the array space.
+ *
+ *     const daa_geom *g
+ *        the block geometry.
+ *
+ *     char **data_ptr
+ *        returned start of the data area.
+ *
+ *     char **ptr_ptr
+ *        returned start of the pointer area.
+ */
 
+    static void
+blk_place(
+    char *base_ptr,
+    const daa_geom *g,
+    char **data_ptr,
+    char **ptr_ptr)
+{
+    if ( (g->flags & (DAA_PTRS_FIRST | DAA_NO_PTRS)) == DAA_PTRS_FIRST )
+    {
+        *ptr_ptr = g->rel ? base_ptr : align_ptr(base_ptr, g->entry_size);
+        *data_ptr = align_ptr(*ptr_ptr + g->ptr_bytes, g->align);
+        return;
+    }
+
+    if ( g->rel )
+    {
+        *data_ptr = base_ptr;
+        *ptr_ptr = base_ptr + (g->data_bytes + g->entry_size - 1) / g->entry_size *
+            g->entry_size;
+        return;
+    }
+
+    *data_ptr = align_ptr(base_ptr, g->align);
+    *ptr_ptr = align_ptr(*data_ptr + g->data_bytes, g->entry_size);
+}
+
+/*
+ * ptr_start:
+ *     calculate address of start of pointers, the first sizeof(char *)
+ *     aligned address at or after the end of the data area.
+ *
+ * Arguments:
+ *     char *data_ptr
+ *        points to base of allocated array.
+ *
+ *     size_t data_bytes
+ *        byte size of the data area.
+ *
+ * Returns:
+ *     pointer to base of pointers to pointers to ... to data
+ */
+
+    static char *
+ptr_start(
+    char *data_ptr,
+    size_t data_bytes)
+{
+    size_t i;
+    char *ptr_ptr;
+
+
+    ptr_ptr = data_ptr + data_bytes;
+
+    for ( i = 0 ; i < sizeof(char *) ; i++, ++ptr_ptr )
+    {
+        if ( ((size_t)ptr_ptr)%sizeof(char *) == 0 )
+        {
+            break;
+        }
+    }
+
+    return ptr_ptr;
+}
+
+/*
+ * ptr_rows:
+ *     this routine uses the space pointed to by the "ptr_ptr" pointer.
+ *     it constructs the part of the several levels of pointers needed to
+ *     reference elements of a multidimensional array that belongs to a
+ *     range of rows of one level.
+ *
+ *     the pointer arrays are built level by level, each in one sequential
+ *     sweep.  pointer i of level l points to the i'th row of the level l+1
+ *     pointer array(or of the data area for the last level), where a row
+ *     is dim[l+1] units long, adjusted by st[l+1] for a non-zero based
+ *     subscript.  successive pointers of a level therefore differ by a
+ *     constant step and no per pointer offset calculation is needed.  the
+ *     work done is proportional to the number of pointers and the stack
+ *     depth is constant.
+ *
+ *     a unit is one element of the level row_level pointer array, that
+ *     is, one combination of the first row_level+1 subscripts.  the
+ *     pointers below a unit at level l >= row_level are a contiguous range
+ *     of dp[l]/dp[row_level] pointers.  a pointer at a level l < row_level
+ *     is above dp[row_level]/dp[l] units and is built with the range that
+ *     holds the first of them.  disjoint unit ranges that together cover
+ *     0 to dp[row_level] can therefore be built independently, and
+ *     together build every pointer exactly once.  a row_level of 0 and
+ *     units 0 to dim[0] build all the pointers.
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     size_t pitch
+ *        byte length of an innermost data row, dim[num_dim-1] * data_size
+ *        unless the rows are padded(DAA_PAD_ROWS).
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     char *data_ptr
+ *        points to base of allocated array.
+ *
+ *     char *ptr_ptr
+ *        points to base of pointers to pointers to ... to data
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts for
+ *        each corresponding dimension of the dim array, elements may
+ *        be negative.
+ *
+ *     size_t *dp
+ *        array of dimension products.
+ *
+ *     unsigned int row_level
+ *        level whose pointer array elements are the units, < num_dim - 1.
+ *
+ *     size_t u0, u1
+ *        build the pointers of units u0 to u1-1.
+ */
+
+    static void
+ptr_rows(
+    size_t data_size,
+    size_t pitch,
+    unsigned int num_dim,
+    char *data_ptr,
+    char *ptr_ptr,
+    size_t *dim,
+    ptrdiff_t *st,
+    size_t *dp,
+    unsigned int row_level,
+    size_t u0,
+    size_t u1)
+{
+    char **ptrs,  /* pointer array of the current level */
+         *p;      /* next level row the current pointer points to */
+
+    unsigned int level;
+    size_t i, i0, i1;
+    size_t r;     /* units per pointer above row_level */
+    size_t step;  /* byte length of a next level row */
+
+
+    ptrs = (char **) ptr_ptr;
+    for ( level = 0 ; level < num_dim - 1 ; level++ )
+    {
+        /* pointers of the unit range at this level */
+        if ( level >= row_level )
+        {
+            i0 = u0 * (dp[level] / dp[row_level]);
+            i1 = u1 * (dp[level] / dp[row_level]);
+        }
+        else
+        {
+            r = dp[row_level] / dp[level];
+            i0 = (u0 + r - 1) / r;
+            i1 = (u1 + r - 1) / r;
+        }
+
+        if ( i0 < i1 )
+        {
+            /*
+             * the next level rows are either pointer array rows or, for the
+             * final pointer level, data rows.  either way they follow one
+             * another with no gaps, starting at the base of the next level.
+             */
+
+            if ( level + 1 < num_dim - 1 )
+            {
+                step = dim[level+1] * sizeof(char *);
+                p = (char *) (ptrs + dp[level] - st[level+1]);
+            }
+            else
+            {
+                step = pitch;
+                p = data_ptr - st[level+1] * (ptrdiff_t) data_size;
+            }
+
+            for ( i = i0, p += i0 * step ; i < i1 ; i++, p += step )
+            {
+                ptrs[i] = p;
+            }
+        }
+
+        ptrs += dp[level];
+    }
+}
+
+/*
+ * ptr_top:
+ *     the pointer daa() returns, the zeroth level of indirection adjusted
+ *     by st[0].  for a one dimensional array there are no pointers and this
+ *     is the data pointer adjusted by st[0].
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     char *data_ptr
+ *        points to base of allocated array.
+ *
+ *     char *ptr_ptr
+ *        points to base of pointers to pointers to ... to data
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts.
+ *
+ * Returns:
+ *     pointer to the zeroth level of indirection.
+ */
+
+    static char *
+ptr_top(
+    size_t data_size,
+    unsigned int num_dim,
+    char *data_ptr,
+    char *ptr_ptr,
+    ptrdiff_t *st)
+{
+    if ( num_dim == 1 )
+    {
+        return data_ptr - st[0] * (ptrdiff_t) data_size;
+    }
+
+    return (char *) ((char **) ptr_ptr - st[0]);
+}
+
+/*
+ * ptr_init:
+ *     this routine uses the space pointed to by the "ptr_ptr" pointer.
+ *     it constructs the several levels of pointers needed to reference
+ *     elements of a multidimensional array.
+ *
+ * Arguments:
+ *     see ptr_rows().
+ *
+ * Returns:
+ *     pointer to the zeroth level of indirection adjusted by st[0].
+ */
+
+    static char *
+ptr_init(
+    size_t data_size,
+    size_t pitch,
+    unsigned int num_dim,
+    char *data_ptr,
+    char *ptr_ptr,
+    size_t *dim,
+    ptrdiff_t *st,
+    size_t *dp)
+{
+    ptr_rows(data_size, pitch, num_dim, data_ptr, ptr_ptr, dim, st, dp, 0, 0,
+        dp[0]);
+
+    return ptr_top(data_size, num_dim, data_ptr, ptr_ptr, st);
+}
+
+/*
+ * off_rows:
+ *     the DAA_OFF32 and DAA_REL version of ptr_rows() for all the rows.  the pointer
+ *     area holds E offsets from base_ptr instead of pointers.  entry i of
+ *     level l is the offset of the i'th row of the level l+1 offset table
+ *     (or of the data area for the last level), adjusted by st[l+1].  the
+ *     adjustment may take an offset below zero, so offsets are computed
+ *     modulo the range of E and the sum of an offset and a scaled valid
+ *     subscript is again a valid offset modulo that range, see daa_off().
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.
+ *
+ *     size_t pitch
+ *        byte length of an innermost data row, see ptr_rows().
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     char *base_ptr
+ *        points to base of allocated array, the offset origin.
+ *
+ *     char *data_ptr
+ *        points to the data area.
+ *
+ *     char *tab_ptr
+ *        points to the base of the offset tables.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions.
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts.
+ *
+ *     size_t *dp
+ *        array of dimension products.
+ */
+
+template <class E>
+    static void
+off_rows(
+    size_t data_size,
+    size_t pitch,
+    unsigned int num_dim,
+    char *base_ptr,
+    char *data_ptr,
+    char *tab_ptr,
+    size_t *dim,
+    ptrdiff_t *st,
+    size_t *dp)
+{
+    E *tab = (E *) tab_ptr;  /* offset table of the current level */
+
+    unsigned int level;
+    size_t i;
+    size_t o;     /* offset of the next level row of the current entry */
+    size_t step;  /* byte length of a next level row */
+
+
+    for ( level = 0 ; level < num_dim - 1 ; level++ )
+    {
+        if ( level + 1 < num_dim - 1 )
+        {
+            step = dim[level+1] * sizeof(E);
+            o = (size_t) ((char *) (tab + dp[level]) - base_ptr) -
+                st[level+1] * sizeof(E);
+        }
+        else
+        {
+            step = pitch;
+            o = (size_t) (data_ptr - base_ptr) - st[level+1] * data_size;
+        }
+
+        for ( i = 0 ; i < dp[level] ; i++, o += step )
+        {
+            tab[i] = (E) o;
+        }
+
+        tab += dp[level];
+    }
+}
+
+/*
+ * wide_fill:
+ *     fill total bytes with the init value of a data item whose size
+ *     divides WIDE_FILL.  the init value is repeated into a WIDE_FILL byte
+ *     pattern that is stored a pattern at a time.  memcpy() of the compile
+ *     time constant size compiles to register wide unaligned stores.
+ *
+ * Arguments:
+ *     char *p_data
+ *        points to the first data item to fill.
+ *
+ *     size_t total
+ *        number of bytes to fill, a multiple of data_size.
+ *
+ *     size_t data_size
+ *        size of the basic array data object, a divisor of WIDE_FILL.
+ *
+ *     char *init_ptr
+ *        points to the init value, data_size bytes.
+ */
+
+    static void
+wide_fill(
+    char *p_data,
+    size_t total,
+    size_t data_size,
+    char *init_ptr)
+{
+    size_t i;
+    char v[WIDE_FILL];
+
+
+    for ( i = 0 ; i < WIDE_FILL ; i += data_size )
+    {
+        memcpy(v + i, init_ptr, data_size);
+    }
+
+    for ( i = 0 ; i + WIDE_FILL <= total ; i += WIDE_FILL )
+    {
+        memcpy(p_data + i, v, WIDE_FILL);
+    }
+
+    memcpy(p_data + i, v, total - i);
+}
+
+/*
+ * data_fill:
+ *     fill num_elem consecutive data items with the init value.  an all
+ *     zero init value, or a one byte data item, is a memset().  2, 4, 8 and
+ *     16 byte data items are stored WIDE_FILL bytes at a time by
+ *     wide_fill().  for any other size the init value is copied once and then doubled with
+ *     memcpy() until it fills a block of about FILL_BLOCK bytes(a whole
+ *     number of data items), and that cache resident block is copied with
+ *     memcpy() over the rest of the area.
+ *
+ * Arguments:
+ *     char *p_data
+ *        points to the first data item to fill.
+ *
+ *     size_t num_elem
+ *        number of data items to fill.
+ *
+ *     size_t data_size
+ *        size of the basic array data object.
+ *
+ *     char *init_ptr
+ *        points to the init value, data_size bytes.
+ */
+
+    static void
+data_fill(
+    char *p_data,
+    size_t num_elem,
+    size_t data_size,
+    char *init_ptr)
+{
+    size_t i;
+    size_t total, /* bytes to fill */
+           blk,   /* bytes in the replication block */
+           done,  /* bytes filled so far */
+           n;     /* bytes in the current copy */
+
+
+    if ( num_elem == 0 )
+    {
+        return;
+    }
+    total = num_elem * data_size;
+
+    /* all zero or one byte init value */
+    for ( i = 0 ; i < data_size ; i++ )
+    {
+        if ( init_ptr[i] != 0 )
+        {
+            break;
+        }
+    }
+    if ( i == data_size || data_size == 1 )
+    {
+        memset(p_data, init_ptr[0], total);
+        return;
+    }
+
+    if ( WIDE_FILL % data_size == 0 )
+    {
+        wide_fill(p_data, total, data_size, init_ptr);
+        return;
+    }
+
+    blk = (FILL_BLOCK / data_size) * data_size;
+    if ( blk == 0 )
+    {
+        blk = data_size;
+    }
+    if ( blk > total )
+    {
+        blk = total;
+    }
+
+    /* seed the block by doubling */
+    memcpy(p_data, init_ptr, data_size);
+    for ( done = data_size ; done < blk ; done += n )
+    {
+        n = (done < blk - done) ? done : blk - done;
+        memcpy(p_data + done, p_data, n);
+    }
+
+    /* replicate the block */
+    for ( ; done < total ; done += n )
+    {
+        n = (blk < total - done) ? blk : total - done;
+        memcpy(p_data + done, p_data, n);
+    }
+}
+
+/*
+ * blk_fill:
+ *     initialize the elements under dimension 0 subscripts u0 to u1-1(zero
+ *     based) of the data area of a block with geometry g, row by row if
+ *     the rows are padded.
+ *
+ * Arguments:
+ *     char *data_ptr
+ *        start of the data area.
+ *
+ *     size_t data_size
+ *        size of the basic array data object.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions.
+ *
+ *     const daa_geom *g
+ *        the block geometry.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ *     size_t u0, u1
+ *        initialize dimension 0 elements u0 to u1-1.
+ */
+
+    static void
+blk_fill(
+    char *data_ptr,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_geom *g,
+    char *init_ptr,
+    size_t u0,
+    size_t u1)
+{
+    size_t r;
+    size_t unit_items;  /* data items under one dimension 0 element */
+    size_t unit_rows;   /* innermost rows under one dimension 0 element */
+
+
+    if ( num_dim == 1 || g->pitch == dim[num_dim-1] * data_size )
+    {
+        unit_items = g->dp[num_dim-1] / g->dp[0];
+        data_fill(data_ptr + u0 * unit_items * data_size, (u1 - u0) * unit_items,
+            data_size, init_ptr);
+        return;
+    }
+
+    unit_rows = g->dp[num_dim-2] / g->dp[0];
+    for ( r = u0 * unit_rows ; r < u1 * unit_rows ; r++ )
+    {
+        data_fill(data_ptr + r * g->pitch, dim[num_dim-1], data_size, init_ptr);
+    }
+}
+
+
+/*
+ * init_skip:
+ *     true if the data area of a block with geometry g needs no
+ *     initialization, for no init_ptr or for a DAA_ZEROED layout and an
+ *     init value whose bytes are all zero.
+ *
+ * Arguments:
+ *     const daa_geom *g
+ *        the block geometry.
+ *
+ *     const char *init_ptr
+ *        initialization pointer parameter.
+ *
+ *     size_t data_size
+ *        size of the basic array data object.
+ */
+
+    static int
+init_skip(
+    const daa_geom *g,
+    const char *init_ptr,
+    size_t data_size)
+{
+    size_t i;
+
+
+    if ( init_ptr == NULL )
+    {
+        return 1;
+    }
+    if ( (g->flags & DAA_ZEROED) == 0 )
+    {
+        return 0;
+    }
+    for ( i = 0 ; i < data_size ; i++ )
+    {
+        if ( init_ptr[i] != 0 )
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+/*
+ * das:
+ *     dynamic array size.  this routine takes five of the same arguments
+ *     that daa() takes and calculates the total space allocation in bytes
+ *     required to store the array with the given layout, and how
+ *     that space divides into data, tables and alignment slack.  normally used in
+ *     conjunction with daa() to do a das()/malloc()/daa() sequence.
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     const daa_layout *layout
+ *        layout options, or NULL for the default layout.
+ *
+ *     daa_stats *stats
+ *        returned space used by each part of the block, or NULL.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size in bytes of dynamic array that daa() will use.
+ *
+ *     routine failure returns 0 and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds size_t.
+ *     ERRS_OFF32_RANGE - DAA_OFF32 block larger than 4 GiB.
+ */
+
+    inline size_t
+das(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_layout *layout,
+    daa_stats *stats,
+    int *err_code)
+{
+    daa_geom g;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return 0;
+    }
+
+    if ( stats != NULL )
+    {
+        stats->data_bytes = g.dp[num_dim-1] * data_size;
+        stats->ptr_bytes = g.ptr_bytes;
+        stats->pad_bytes = g.size - stats->data_bytes - g.ptr_bytes;
+        stats->size = g.size;
+        stats->page_kind = DAA_PAGE_UNKNOWN;
+    }
+
+    return g.size;
+}
+
+/*
+ * das:
+ *     dynamic array size.  this routine takes five of the same arguments
+ *     that daa() takes and calculates the total space allocation in bytes
+ *     required to store the array with the given layout.  normally used in
+ *     conjunction with daa() to do a das()/malloc()/daa() sequence.
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     const daa_layout *layout
+ *        layout options, or NULL for the default layout.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size in bytes of dynamic array that daa() will use.
+ *
+ *     routine failure returns 0 and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds size_t.
+ *     ERRS_OFF32_RANGE - DAA_OFF32 block larger than 4 GiB.
+ */
+
+    inline size_t
+das(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_layout *layout,
+    int *err_code)
+{
+    return das(data_size, num_dim, dim, layout, (daa_stats *) NULL, err_code);
+}
+
+/*
+ * das:
+ *     dynamic array size.  this routine takes four of the same arguments
+ *     that daa() takes and calculates the total space allocation in bytes
+ *     required to store the array.  normally used in conjunction with
+ *     daa() to do a das()/malloc()/daa() sequence.
+ *
+ *     this is the size_t version for arrays of any size the address space
+ *     allows.  the int version below is limited to INT_MAX bytes.
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size in bytes of dynamic array that daa() will use.
+ *
+ *     routine failure returns 0 and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds size_t.
+ */
+
+    inline size_t
+das(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    int *err_code)
+{
+    return das(data_size, num_dim, dim, (const daa_layout *) NULL, err_code);
+}
+
+/*
+ * das:
+ *     dynamic array size.  this routine takes four of the same arguments
+ *     that daa() takes and calculates the total space allocation in bytes
+ *     required to store the array.  normally used in conjunction with
+ *     daa() to do a das()/malloc()/daa() sequence.
+ *
+ * Arguments:
+ *     unsigned int data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     unsigned int *dim
+ *        a single dimensional int array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size in bytes of dynamic array that daa() will use.
+ *
+ *     routine failure returns -1 and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds INT_MAX, use
+ *                          the size_t version.
+ */
+
+    inline int
+das(
+    unsigned int data_size,
+    unsigned int num_dim,
+    unsigned int *dim,
+    int *err_code)
+{
+    unsigned int i;
+    size_t size;
+
+    /* dimensions converted for the size_t version */
+    size_t sdim[MAX_DIM];
+
+
+    if ( num_dim < 1 || num_dim > MAX_DIM )
+    {
+        *err_code = ERRS_INV_DIMS;
+        return -1;
+    }
+
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        sdim[i] = dim[i];
+    }
+
+    size = das((size_t) data_size, num_dim, sdim, err_code);
+    if ( size == 0 )
+    {
+        return -1;
+    }
+
+    if ( size > (size_t) INT_MAX )
+    {
+        *err_code = ERRS_SIZE_OVERFLOW;
+        return -1;
+    }
+
+    return (int) size;
+}
+
+/*
+ * daa:
+ *     dynamic array allocator, with layout options.
+ *
+ *     the space pointed to by base_ptr must be the size returned by das()
+ *     for the same layout.  with DAA_NO_PTRS only the data area is
+ *     initialized and there are no pointers, use dad() to access the array.
+ *     with DAA_OFF32 the pointer area holds 32 bit offsets from base_ptr,
+ *     half the size of pointers on a 64 bit machine, use daa_off() to
+ *     access the array.  with DAA_REL it holds size_t offsets from
+ *     base_ptr.  both are position independent, see daa_attach().
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts for
+ *        each corresponding dimension of the dim array, elements may
+ *        be negative.
+ *
+ *     const daa_layout *layout
+ *        layout options, or NULL for the default layout.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ * Returns:
+ *     see the daa() below.  with DAA_NO_PTRS the start of the data area.
+ *     with DAA_OFF32 the zeroth level offset table adjusted by st[0], a
+ *     daa_u32 *, or for a one dimensional array the data pointer adjusted
+ *     by st[0].  DAA_REL likewise with a size_t *.  DAA_NO_PTRS takes
+ *     precedence over DAA_OFF32 and DAA_REL, DAA_OFF32 over DAA_REL.
+ *     ERRS_OFF32_RANGE - DAA_OFF32 block larger than 4 GiB.
+ *     ERRS_INV_ALIGN - base_ptr of a DAA_OFF32 or DAA_REL block not aligned.
+ */
+
+    inline void *
+daa(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr)
+{
+    daa_geom g;
+
+    /* points to base of data */
+    char *data_ptr;
+
+    /* points to base of pointers to pointers to ... to data */
+    char *ptr_ptr;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    /*
+     * calculate address of start of data and of pointers.  If not
+     * aligned make them so.
+     */
+    if ( g.rel && ((size_t) base_ptr % g.align != 0 ||
+        (size_t) base_ptr % g.entry_size != 0) )
+    {
+        *err_code = ERRS_INV_ALIGN;
+        return NULL;
+    }
+    blk_place(base_ptr, &g, &data_ptr, &ptr_ptr);
+
+    /* if init_ptr is NULL, or zero in zeroed space, skip initialization */
+    if ( !init_skip(&g, init_ptr, data_size) )
+    {
+        blk_fill(data_ptr, data_size, num_dim, dim, &g, init_ptr, 0, dim[0]);
+    }
+
+    if ( g.flags & DAA_NO_PTRS )
+    {
+        return data_ptr;
+    }
+
+    if ( g.rel && num_dim == 1 )
+    {
+        return data_ptr - st[0] * (ptrdiff_t) data_size;
+    }
+
+    if ( g.flags & DAA_OFF32 )
+    {
+        off_rows<daa_u32>(data_size, g.pitch, num_dim, base_ptr, data_ptr,
+            ptr_ptr, dim, st, g.dp);
+        return (char *) ((daa_u32 *) ptr_ptr - st[0]);
+    }
+
+    if ( g.flags & DAA_REL )
+    {
+        off_rows<size_t>(data_size, g.pitch, num_dim, base_ptr, data_ptr,
+            ptr_ptr, dim, st, g.dp);
+        return (char *) ((size_t *) ptr_ptr - st[0]);
+    }
+
+    /* do array setup i.e. all the pointer stuff */
+    return ptr_init(data_size, g.pitch, num_dim, data_ptr, ptr_ptr, dim, st,
+        g.dp);
+}
+
+/*
+ * daa:
+ *     dynamic array allocator
+ *
+ *     this is the size_t version for arrays of any size the address space
+ *     allows.  the space pointed to by base_ptr must be the size returned
+ *     by the size_t version of das().
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts for
+ *        each corresponding dimension of the dim array, elements may
+ *        be negative.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ * Returns:
+ *     error free operation returns a pointer to void that points to the start
+ *     of the dynamically allocated array area and does not set *err_code.  the
+ *     returned pointer will need to be cast to the type of the subsequent array
+ *     references.
+ *
+ *     routine failure returns NULL and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds size_t.
+ *
+ *     failure to index the subscripts in the manner established by the starting
+ *     index and the dimensional extent will of course result in run time errors.
+ *     this is not an array allocation error but an array usage error, similar
+ *     to any array access on a static C zero based array outside the normal
+ *     0...n-1 bounds.
+ */
+
+    inline void *
+daa(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr)
+{
+    return daa(data_size, num_dim, dim, st, (const daa_layout *) NULL,
+        err_code, base_ptr, init_ptr);
+}
+
+/*
+ * daa:
+ *     dynamic array allocator
+ *
+ * Arguments:
+ *     unsigned int data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     unsigned int *dim
+ *        a single dimensional int array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     int *st
+ *        a single dimensional int array of integer start subscripts for
+ *        each corresponding dimension of the dim array, elements may
+ *        be negative.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ * Returns:
+ *     error free operation returns a pointer to void that points to the start
+ *     of the dynamically allocated array area and does not set *err_code.  the
+ *     returned pointer will need to be cast to the type of the subsequent array
+ *     references.
+ *
+ *     routine failure returns NULL and any of the following
+ *     error codes in *err_code:
+ *     ERRS_INV_DIMS - invalid number of dimensions - must be > 0 and <= MAX_DIM.
+ *     ERRS_INV_REQ_SIZE - invalid request size - must be > 0.
+ *     ERRS_INV_DIM - invalid dimension - must be > 0.
+ *     ERRS_SIZE_OVERFLOW - array size overflow - size exceeds size_t.
+ *
+ *     failure to index the subscripts in the manner established by the starting
+ *     index and the dimensional extent will of course result in run time errors.
+ *     this is not an array allocation error but an array usage error, similar
+ *     to any array access on a static C zero based array outside the normal
+ *     0...n-1 bounds.
+ */
+
+    inline void *
+daa(
+    unsigned int data_size,
+    unsigned int num_dim,
+    unsigned int *dim,
+    int *st,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr)
+{
+    unsigned int i;
+
+    /* dimensions and start subscripts converted for the size_t version */
+    size_t sdim[MAX_DIM];
+    ptrdiff_t sst[MAX_DIM];
+
+
+    if ( num_dim < 1 || num_dim > MAX_DIM )
+    {
+        *err_code = ERRS_INV_DIMS;
+        return NULL;
+    }
+
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        sdim[i] = dim[i];
+        sst[i] = st[i];
+    }
+
+    return daa((size_t) data_size, num_dim, sdim, sst, err_code, base_ptr,
+        init_ptr);
+}
+
+/*
+ * dad:
+ *     dynamic array descriptor.  fill in the descriptor(dope vector) of an
+ *     array built by daa() in the space pointed to by base_ptr.  the
+ *     descriptor indexes the data area directly with one multiply-add per
+ *     dimension and no pointer loads, see daa_at().  it works for any
+ *     layout, including DAA_NO_PTRS which has no pointers at all.  the
+ *     array data area is row major, the last dimension varies fastest.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code, char *base_ptr
+ *        the same arguments given to daa().
+ *
+ *     daa_desc *desc
+ *        returned descriptor.
+ *
+ * Returns:
+ *     desc, or NULL and an error code in *err_code, see daa().
+ */
+
+    inline daa_desc *
+dad(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    daa_desc *desc)
+{
+    unsigned int i;
+    daa_geom g;
+    char *ptr_ptr;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    blk_place(base_ptr, &g, &desc->data, &ptr_ptr);
+    desc->data_size = data_size;
+    desc->num_dim = num_dim;
+    desc->origin = desc->data;
+    for ( i = num_dim ; i-- > 0 ; )
+    {
+        desc->dim[i] = dim[i];
+        desc->st[i] = st[i];
+        if ( i == num_dim - 1 )
+        {
+            desc->stride[i] = (ptrdiff_t) data_size;
+        }
+        else if ( i == num_dim - 2 )
+        {
+            desc->stride[i] = (ptrdiff_t) g.pitch;
+        }
+        else
+        {
+            desc->stride[i] = desc->stride[i+1] * (ptrdiff_t) dim[i+1];
+        }
+        desc->origin -= st[i] * desc->stride[i];
+    }
+
+    return desc;
+}
+
+/*
+ * daa_at:
+ *     address of an array element through a descriptor filled in by dad().
+ *
+ * Arguments:
+ *     const daa_desc *desc
+ *        the array descriptor.
+ *
+ *     const ptrdiff_t *idx
+ *        the desc->num_dim subscripts of the element.
+ *
+ * Returns:
+ *     pointer to the element, to be cast to the element type.
+ */
+
+    inline char *
+daa_at(
+    const daa_desc *desc,
+    const ptrdiff_t *idx)
+{
+    unsigned int i;
+    char *p = desc->origin;
+
+
+    for ( i = 0 ; i < desc->num_dim ; i++ )
+    {
+        p += idx[i] * desc->stride[i];
+    }
+
+    return p;
+}
+
+/*
+ * dad_sub:
+ *     descriptor of a sub-array, a view of part of the array of src without
+ *     copying.  element new_st[i] + k of dimension i of the view is element
+ *     lo[i] + k*step[i] of src, for k = 0 ... n[i]-1.  a view can take a
+ *     box(a window), every step[i]-th element, run backwards(a negative
+ *     step) or give the array other start subscripts.  the cost is
+ *     proportional to the number of dimensions, the data is not touched.
+ *
+ * Arguments:
+ *     const daa_desc *src
+ *        descriptor of the array, from dad() or dad_sub().
+ *
+ *     const ptrdiff_t *lo
+ *        the src subscripts of the first element of the view.
+ *
+ *     const size_t *n
+ *        the view dimensions.
+ *
+ *     const ptrdiff_t *step
+ *        the src subscript step of each dimension, != 0, or NULL for all 1.
+ *
+ *     const ptrdiff_t *new_st
+ *        the view start subscripts, or NULL for lo.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_desc *dst
+ *        returned descriptor, may be src.
+ *
+ * Returns:
+ *     dst, or NULL and an error code in *err_code.
+ *     ERRS_INV_DIM - a view dimension is 0.
+ *     ERRS_VIEW_BOX - a step is 0 or the view is not within the array.
+ */
+
+    inline daa_desc *
+dad_sub(
+    const daa_desc *src,
+    const ptrdiff_t *lo,
+    const size_t *n,
+    const ptrdiff_t *step,
+    const ptrdiff_t *new_st,
+    int *err_code,
+    daa_desc *dst)
+{
+    unsigned int i;
+    ptrdiff_t s;        /* step of dimension i */
+    ptrdiff_t last;     /* src subscript of the last view element */
+    char *first;        /* address of the first view element */
+
+
+    first = src->origin;
+    for ( i = 0 ; i < src->num_dim ; i++ )
+    {
+        s = (step != NULL) ? step[i] : 1;
+        if ( n[i] == 0 )
+        {
+            *err_code = ERRS_INV_DIM;
+            return NULL;
+        }
+        if ( s == 0 || (n[i] - 1) > src->dim[i] / (size_t) (s < 0 ? -s : s) )
+        {
+            *err_code = ERRS_VIEW_BOX;
+            return NULL;
+        }
+        last = lo[i] + (ptrdiff_t) (n[i] - 1) * s;
+        if ( lo[i] < src->st[i] || lo[i] >= src->st[i] + (ptrdiff_t) src->dim[i] ||
+            last < src->st[i] || last >= src->st[i] + (ptrdiff_t) src->dim[i] )
+        {
+            *err_code = ERRS_VIEW_BOX;
+            return NULL;
+        }
+        first += lo[i] * src->stride[i];
+    }
+
+    dst->data = first;
+    dst->origin = first;
+    dst->data_size = src->data_size;
+    dst->num_dim = src->num_dim;
+    for ( i = 0 ; i < src->num_dim ; i++ )
+    {
+        dst->stride[i] = src->stride[i] * ((step != NULL) ? step[i] : 1);
+        dst->dim[i] = n[i];
+        dst->st[i] = (new_st != NULL) ? new_st[i] : lo[i];
+        dst->origin -= dst->st[i] * dst->stride[i];
+    }
+
+    return dst;
+}
+
+/*
+ * das_sub:
+ *     size of the pointer table daa_sub() builds for a view.  it holds the
+ *     pointers of all but the last dimension of the view, so it is
+ *     proportional to the number of innermost rows, not to the data.
+ *
+ * Arguments:
+ *     const daa_desc *desc
+ *        descriptor of the view, from dad() or dad_sub().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size of the table in bytes, at least one pointer, or 0 and an error
+ *     code in *err_code.
+ *     ERRS_SIZE_OVERFLOW - the table size exceeds the range of size_t.
+ */
+
+    inline size_t
+das_sub(
+    const daa_desc *desc,
+    int *err_code)
+{
+    unsigned int i;
+    size_t p = 1;       /* pointers of level i */
+    size_t count = 0;   /* pointers of levels 0 ... i */
+
+
+    for ( i = 0 ; i + 1 < desc->num_dim ; i++ )
+    {
+        if ( p > ((size_t) -1) / desc->dim[i] )
+        {
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return 0;
+        }
+        p *= desc->dim[i];
+        if ( count > ((size_t) -1) / sizeof(char *) - p )
+        {
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return 0;
+        }
+        count += p;
+    }
+
+    return (count > 0 ? count : 1) * sizeof(char *);
+}
+
+/*
+ * daa_sub:
+ *     build the pointer table of a view in the space pointed to by
+ *     base_ptr, das_sub() bytes aligned for a char *.  the returned pointer
+ *     indexes the view like a daa() array, array[i0][i1]...[in-1], over
+ *     the data of the original array, which must stay allocated.  the
+ *     pointers are built level by level, one pass per level, the last
+ *     level with one add per pointer, so the cost is proportional to the
+ *     pointer count.  the view space is released with free() on base_ptr
+ *     or whatever matches its allocation.  a one dimensional view needs
+ *     no table, its pointer is returned and base_ptr is not used.
+ *
+ * Arguments:
+ *     const daa_desc *desc
+ *        descriptor of the view, from dad() or dad_sub().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the table space.
+ *
+ * Returns:
+ *     the array pointer of the view, or NULL and an error code in
+ *     *err_code.
+ *     ERRS_VIEW_STEP - the last dimension step is not 1, the elements of
+ *     a row must be contiguous for pointer indexing, use daa_at().
+ */
+
+    inline void *
+daa_sub(
+    const daa_desc *desc,
+    int *err_code,
+    char *base_ptr)
+{
+    unsigned int i;
+    unsigned int n = desc->num_dim;
+    size_t cnt[MAX_DIM];    /* odometer of the row subscripts */
+    size_t p = 1;           /* pointers of level i */
+    size_t r;
+    char **lvl;             /* the pointers of level i */
+    char **next;            /* the pointers of level i + 1 */
+    char *row;              /* the zero subscript address of a row */
+
+
+    if ( desc->stride[n-1] != (ptrdiff_t) desc->data_size )
+    {
+        *err_code = ERRS_VIEW_STEP;
+        return NULL;
+    }
+    if ( n == 1 )
+    {
+        return desc->origin;
+    }
+
+    /* pointer levels 0 ... n-3 point to the next level */
+    lvl = (char **) base_ptr;
+    for ( i = 0 ; i + 2 < n ; i++ )
+    {
+        p *= desc->dim[i];
+        next = lvl + p;
+        for ( r = 0 ; r < p ; r++ )
+        {
+            lvl[r] = (char *) (next + r * desc->dim[i+1] - desc->st[i+1]);
+        }
+        lvl = next;
+    }
+    p *= desc->dim[n-2];
+
+    /* level n-2 points to the rows, the odometer steps the row address */
+    row = desc->origin;
+    for ( i = 0 ; i + 1 < n ; i++ )
+    {
+        cnt[i] = 0;
+        row += desc->st[i] * desc->stride[i];
+    }
+    for ( r = 0 ; r < p ; r++ )
+    {
+        lvl[r] = row;
+        for ( i = n - 1 ; i-- > 0 ; )
+        {
+            row += desc->stride[i];
+            if ( ++cnt[i] < desc->dim[i] )
+            {
+                break;
+            }
+            cnt[i] = 0;
+            row -= (ptrdiff_t) desc->dim[i] * desc->stride[i];
+        }
+    }
+
+    return (char **) base_ptr - desc->st[0];
+}
+
+/*
+ * adopt_geom:
+ *     the geometry of the pointer area daa_adopt() builds, from the align,
+ *     DAA_PAD_ROWS and cap0 of layout.  the other flags do not apply, the
+ *     table is always of plain pointers.
+ *
+ * Arguments:
+ *     see das_adopt().
+ *
+ *     daa_geom *g
+ *        returned geometry.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set.
+ */
+
+    static int
+adopt_geom(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_layout *layout,
+    daa_geom *g,
+    int *err_code)
+{
+    daa_layout split = {0, 0, 0};
+
+
+    if ( layout != NULL )
+    {
+        split = *layout;
+        split.flags &= DAA_PAD_ROWS;
+    }
+
+    return geom(data_size, num_dim, dim, &split, g, err_code);
+}
+
+/*
+ * das_adopt:
+ *     size of the pointer area daa_adopt() builds over data the caller
+ *     already has.  the data is not counted, only the pointers.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim
+ *        see daa().
+ *
+ *     const daa_layout *layout
+ *        layout of the data, or NULL for dense rows.  the align and
+ *        DAA_PAD_ROWS describe the rows, a cap0 the dimension 0 capacity
+ *        of the data.  the other flags are ignored.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     size of the pointer area in bytes, at least one pointer, or 0 and an
+ *     error code in *err_code, see das().
+ */
+
+    inline size_t
+das_adopt(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_layout *layout,
+    int *err_code)
+{
+    daa_geom g;
+
+
+    if ( adopt_geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return 0;
+    }
+
+    return (g.ptr_bytes > 0) ? g.ptr_bytes : sizeof(char *);
+}
+
+/*
+ * daa_adopt:
+ *     build the pointers of an array over a data area the caller already
+ *     has, such as a DMA buffer, a received message or part of a mapped
+ *     file, with the pointers in a separate area of das_adopt() bytes.
+ *     the data is row major, the last dimension varies fastest, and is
+ *     neither copied nor initialized.  the data must stay allocated while
+ *     the array is used, the pointer area is released on its own.  a one
+ *     dimensional array needs no pointers and ptr_area is not used.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     int *err_code
+ *        see daa().
+ *
+ *     const daa_layout *layout
+ *        layout of the data, see das_adopt().
+ *
+ *     char *data_ptr
+ *        the data, aligned to the layout align.
+ *
+ *     char *ptr_area
+ *        the pointer area, aligned for a char *.
+ *
+ * Returns:
+ *     the array pointer, or NULL and an error code in *err_code, see das().
+ *     ERRS_INV_ALIGN - data_ptr or ptr_area is not aligned.
+ */
+
+    inline void *
+daa_adopt(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *data_ptr,
+    char *ptr_area)
+{
+    daa_geom g;
+
+
+    if ( adopt_geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+    if ( (size_t) data_ptr % g.align != 0 ||
+        (num_dim > 1 && (size_t) ptr_area % sizeof(char *) != 0) )
+    {
+        *err_code = ERRS_INV_ALIGN;
+        return NULL;
+    }
+
+    return ptr_init(data_size, g.pitch, num_dim, data_ptr, ptr_area, dim, st, g.dp);
+}
+
+/*
+ * daa_off:
+ *     address of an array element of a DAA_OFF32 array.  each level is one
+ *     32 bit load and one multiply-add, the same work as a pointer level.
+ *
+ * Arguments:
+ *     char *base_ptr
+ *        pointer to the array space given to daa().
+ *
+ *     void *array
+ *        the pointer daa() returned.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t data_size
+ *        size of the basic array data object.
+ *
+ *     const ptrdiff_t *idx
+ *        the num_dim subscripts of the element.
+ *
+ * Returns:
+ *     pointer to the element, to be cast to the element type.
+ */
+
+    inline char *
+daa_off(
+    char *base_ptr,
+    void *array,
+    unsigned int num_dim,
+    size_t data_size,
+    const ptrdiff_t *idx)
+{
+    unsigned int i;
+    daa_u32 o;
+
+
+    if ( num_dim == 1 )
+    {
+        return (char *) array + idx[0] * (ptrdiff_t) data_size;
+    }
+
+    o = ((daa_u32 *) array)[idx[0]];
+    for ( i = 1 ; i < num_dim - 1 ; i++ )
+    {
+        o = *(daa_u32 *) (base_ptr +
+            (daa_u32) (o + idx[i] * (ptrdiff_t) sizeof(daa_u32)));
+    }
+
+    return base_ptr + (daa_u32) (o + idx[num_dim-1] * (ptrdiff_t) data_size);
+}
+
+/*
+ * daa_alloc:
+ *     allocate size bytes aligned to align bytes with malloc().  the space
+ *     must be freed with daa_free().
+ *
+ * Arguments:
+ *     size_t size
+ *        number of bytes, usually from das().
+ *
+ *     size_t align
+ *        alignment in bytes, a power of 2.
+ *
+ * Returns:
+ *     pointer to the aligned space, or NULL if align is not a power of 2 or
+ *     the allocation fails.
+ */
+
+    inline void *
+daa_alloc(
+    size_t size,
+    size_t align)
+{
+    char *p;
+    char *a;
+
+
+    if ( align == 0 || (align & (align - 1)) != 0 )
+    {
+        return NULL;
+    }
+    if ( align < sizeof(void *) )
+    {
+        align = sizeof(void *);
+    }
+
+    /* room for the alignment and for the malloc() pointer before the space */
+    if ( size > ((size_t) -1) - align - sizeof(void *) )
+    {
+        return NULL;
+    }
+    p = (char *) malloc(size + align - 1 + sizeof(void *));
+    if ( p == NULL )
+    {
+        return NULL;
+    }
+
+    a = p + sizeof(void *);
+    a += (align - (size_t) a % align) % align;
+    ((void **) a)[-1] = p;
+
+    return a;
+}
+
+/*
+ * daa_free:
+ *     free space allocated by daa_alloc().  a NULL ptr is ignored.
+ *
+ * Arguments:
+ *     void *ptr
+ *        pointer returned by daa_alloc().
+ */
+
+    inline void
+daa_free(
+    void *ptr)
+{
+    if ( ptr != NULL )
+    {
+        free(((void **) ptr)[-1]);
+    }
+}
+
+/*
+ * daa_attach:
+ *     attach a view to a DAA_OFF32 or DAA_REL block built by daa(),
+ *     possibly by another process or at another address, at the address
+ *     base_ptr it has in this process.  the block is not read or written,
+ *     the view is calculated from the shape and layout alone.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        the same arguments given to daa().
+ *
+ *     char *base_ptr
+ *        the address of the block in this process.
+ *
+ *     daa_view *view
+ *        returned view.
+ *
+ * Returns:
+ *     view, or NULL and an error code in *err_code, see daa().
+ *     ERRS_NOT_REL - the layout is not DAA_OFF32 or DAA_REL, its pointers
+ *     are only valid at the address daa() built it at.
+ */
+
+    inline daa_view *
+daa_attach(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    daa_view *view)
+{
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+    if ( !g.rel )
+    {
+        *err_code = ERRS_NOT_REL;
+        return NULL;
+    }
+    if ( (size_t) base_ptr % g.align != 0 || (size_t) base_ptr % g.entry_size != 0 )
+    {
+        *err_code = ERRS_INV_ALIGN;
+        return NULL;
+    }
+
+    blk_place(base_ptr, &g, &data_ptr, &ptr_ptr);
+    view->base = base_ptr;
+    view->data_size = data_size;
+    view->num_dim = num_dim;
+    view->flags = g.flags & (DAA_OFF32 | DAA_REL);
+    if ( num_dim == 1 )
+    {
+        view->top = (size_t) (data_ptr - base_ptr) - st[0] * data_size;
+    }
+    else
+    {
+        view->top = (size_t) (ptr_ptr - base_ptr) - st[0] * g.entry_size;
+    }
+
+    return view;
+}
+
+/*
+ * daa_view_at:
+ *     address of an array element through a view filled in by
+ *     daa_attach().  each level is one offset load and one multiply-add.
+ *
+ * Arguments:
+ *     const daa_view *view
+ *        the view.
+ *
+ *     const ptrdiff_t *idx
+ *        the view->num_dim subscripts of the element.
+ *
+ * Returns:
+ *     pointer to the element, to be cast to the element type.
+ */
+
+    inline char *
+daa_view_at(
+    const daa_view *view,
+    const ptrdiff_t *idx)
+{
+    unsigned int i;
+    size_t o = view->top;
+    unsigned int n = view->num_dim;
+
+
+    if ( view->flags & DAA_OFF32 )
+    {
+        for ( i = 0 ; i + 1 < n ; i++ )
+        {
+            o = *(daa_u32 *) (view->base +
+                (daa_u32) (o + idx[i] * sizeof(daa_u32)));
+        }
+        return view->base + (daa_u32) (o + idx[n-1] * view->data_size);
+    }
+
+    for ( i = 0 ; i + 1 < n ; i++ )
+    {
+        o = *(size_t *) (view->base + (o + idx[i] * sizeof(size_t)));
+    }
+    return view->base + (o + idx[n-1] * view->data_size);
+}
+
+/*
+ * blk_top:
+ *     the pointer daa() returned for a block with geometry g that is now
+ *     in the space pointed to by base_ptr, with the tables for that space.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, ptrdiff_t *st
+ *        see daa().
+ *
+ *     const daa_geom *g
+ *        the block geometry.
+ *
+ *     char *data_ptr, char *ptr_ptr
+ *        the data and pointer areas, see blk_place().
+ *
+ * Returns:
+ *     the daa() array pointer.
+ */
+
+    static void *
+blk_top(
+    size_t data_size,
+    unsigned int num_dim,
+    ptrdiff_t *st,
+    const daa_geom *g,
+    char *data_ptr,
+    char *ptr_ptr)
+{
+    if ( g->flags & DAA_NO_PTRS )
+    {
+        return data_ptr;
+    }
+    if ( num_dim == 1 )
+    {
+        return data_ptr - st[0] * (ptrdiff_t) data_size;
+    }
+
+    return ptr_ptr - st[0] * (ptrdiff_t) g->entry_size;
+}
+
+/*
+ * blk_move:
+ *     check that a block with geometry g can move from old_base to
+ *     new_base as it is, its parts at the same offsets from the base.
+ *     that holds if the distance is a multiple of the data and the
+ *     pointer area alignments.
+ *
+ * Returns:
+ *     0 if it can, -1 with *err_code set to ERRS_INV_ALIGN if not.
+ */
+
+    static int
+blk_move(
+    const daa_geom *g,
+    char *old_base,
+    char *new_base,
+    int *err_code)
+{
+    size_t delta = (size_t) (new_base - old_base);
+
+
+    if ( delta % g->align != 0 || delta % g->entry_size != 0 )
+    {
+        *err_code = ERRS_INV_ALIGN;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * daa_rebase:
+ *     fix a block built by daa() at old_base that has been moved, by
+ *     realloc(), memcpy(), mremap() or a file write and read, to new_base.
+ *     every pointer is shifted by new_base - old_base in one sequential
+ *     pass over the pointer area, with no per pointer calculation.  the
+ *     base relative layouts(DAA_OFF32, DAA_REL) and DAA_NO_PTRS need no
+ *     change and only the new array pointer is returned.
+ *
+ *     old_base and new_base must be congruent modulo the data alignment
+ *     and sizeof(char *), which holds for any two malloc() or mmap()
+ *     addresses.  otherwise the parts of the block would be at different
+ *     offsets in the new space and daa() must be used again.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        the same arguments given to daa().
+ *
+ *     char *old_base
+ *        the base_ptr the block was built at.  only its value is used.
+ *
+ *     char *new_base
+ *        the address the block is now at.
+ *
+ * Returns:
+ *     the daa() array pointer for the block at new_base, or NULL and an
+ *     error code in *err_code, see daa().
+ *     ERRS_INV_ALIGN - old_base and new_base are not congruent.
+ */
+
+    inline void *
+daa_rebase(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *old_base,
+    char *new_base)
+{
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+    size_t i;
+    ptrdiff_t delta;
+    char **p;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 ||
+        blk_move(&g, old_base, new_base, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    blk_place(new_base, &g, &data_ptr, &ptr_ptr);
+    if ( !g.rel && (g.flags & DAA_NO_PTRS) == 0 )
+    {
+        delta = new_base - old_base;
+        p = (char **) ptr_ptr;
+        for ( i = 0 ; i < g.ptr_count ; i++ )
+        {
+            p[i] += delta;
+        }
+    }
+
+    return blk_top(data_size, num_dim, st, &g, data_ptr, ptr_ptr);
+}
+
+/*
+ * daa_clone:
+ *     copy a block built by daa() at src_base to the space at dst_base,
+ *     which must be the das() size.  the data area is copied with one
+ *     memcpy() and the pointers are copied and shifted to dst_base in the
+ *     same pass, so the clone costs about one pass over the block.  the
+ *     source is not changed.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        the same arguments given to daa().
+ *
+ *     char *src_base
+ *        the block to copy.
+ *
+ *     char *dst_base
+ *        the space to copy it to.
+ *
+ * Returns:
+ *     the daa() array pointer of the clone, or NULL and an error code in
+ *     *err_code, see daa_rebase().
+ */
+
+    inline void *
+daa_clone(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *src_base,
+    char *dst_base)
+{
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+    char *src_data;
+    char *src_ptr;
+    size_t i;
+    ptrdiff_t delta;
+    char **p, **q;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 ||
+        blk_move(&g, src_base, dst_base, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    blk_place(dst_base, &g, &data_ptr, &ptr_ptr);
+    blk_place(src_base, &g, &src_data, &src_ptr);
+    if ( g.rel || (g.flags & DAA_NO_PTRS) )
+    {
+        memcpy(dst_base, src_base, g.size);
+    }
+    else
+    {
+        memcpy(data_ptr, src_data, g.data_bytes);
+        delta = dst_base - src_base;
+        p = (char **) ptr_ptr;
+        q = (char **) src_ptr;
+        for ( i = 0 ; i < g.ptr_count ; i++ )
+        {
+            p[i] = q[i] + delta;
+        }
+    }
+
+    return blk_top(data_size, num_dim, st, &g, data_ptr, ptr_ptr);
+}
+
+/*
+ * daa_grow:
+ *     resize dimension 0 of an array built by daa() with a layout cap0,
+ *     in place.  nothing moves and no pointer is rebuilt, the block was
+ *     sized and its pointers built for cap0 elements of dimension 0.  the
+ *     elements of existing subscripts keep their values, the new elements
+ *     of a larger dimension 0 are initialized, so the cost is proportional
+ *     to the new elements only.  on success dim[0] is set to new_dim0.
+ *     to grow beyond cap0 the block must be rebuilt in a larger space,
+ *     see daa_map_resize() in daa_mmap.hpp.  with DAA_ZEROED the rows a
+ *     smaller dimension 0 gives up are cleared, so the space stays zero.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        the same arguments given to daa(), dim[0] the current dimension.
+ *
+ *     char *base_ptr
+ *        pointer to the array space.
+ *
+ *     size_t new_dim0
+ *        the new dimension 0, > 0 and <= layout->cap0.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter for the new elements.
+ *
+ * Returns:
+ *     the daa() array pointer, unchanged, or NULL and an error code in
+ *     *err_code, see daa().
+ *     ERRS_CAPACITY - new_dim0 is 0 or larger than the layout cap0.
+ */
+
+    inline void *
+daa_grow(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    size_t new_dim0,
+    char *init_ptr)
+{
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+    /* the geometry must not change, dim[0] and new_dim0 within cap0 */
+    if ( new_dim0 != dim[0] && (new_dim0 == 0 || layout == NULL ||
+        layout->cap0 < dim[0] || layout->cap0 < new_dim0) )
+    {
+        *err_code = ERRS_CAPACITY;
+        return NULL;
+    }
+
+    blk_place(base_ptr, &g, &data_ptr, &ptr_ptr);
+    if ( new_dim0 > dim[0] && !init_skip(&g, init_ptr, data_size) )
+    {
+        blk_fill(data_ptr, data_size, num_dim, dim, &g, init_ptr, dim[0], new_dim0);
+    }
+
+    /* keep the rows beyond dimension 0 of zeroed space zero */
+    if ( new_dim0 < dim[0] && (g.flags & DAA_ZEROED) )
+    {
+        memset(data_ptr + g.data_bytes / g.dp[0] * new_dim0, 0,
+            g.data_bytes / g.dp[0] * (dim[0] - new_dim0));
+    }
+    dim[0] = new_dim0;
+
+    return blk_top(data_size, num_dim, st, &g, data_ptr, ptr_ptr);
+}
+
+/*
+ * daa_plan:
+ *     a shape plan, filled in by daa_plan_init().  it holds the geometry of
+ *     a block and a template of its pointer area, so that daa_plan_build()
+ *     builds the same array in any number of blocks without recalculating
+ *     either.  the members are private to the daa_plan_*() routines.
+ */
+
+struct daa_plan
+{
+    size_t data_size;          /* size of the basic array data object */
+    unsigned int num_dim;      /* number of array dimensions */
+    size_t dim[MAX_DIM];       /* dimensions */
+    ptrdiff_t st[MAX_DIM];     /* start subscripts */
+    daa_geom g;                /* the block geometry */
+    ptrdiff_t dist;            /* pointer area - data area of the template */
+    char *tmpl;                /* the pointer area template, ptr_bytes long */
+};
+
+/*
+ * daa_plan_init:
+ *     das() and the pointer construction of daa() done once for a shape and
+ *     layout.  the pointer area is built in a scratch block and kept as a
+ *     template: for the base relative layouts(DAA_OFF32, DAA_REL) the table
+ *     itself, which is the same in every block, otherwise the byte offset of
+ *     every pointer from the start of the pointer area.  release the plan
+ *     with daa_plan_free(), also after a failure.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        see daa().  dim and st are copied into the plan.
+ *
+ *     daa_plan *plan
+ *        returned plan.
+ *
+ * Returns:
+ *     the das() size of a block for the plan, or 0 and an error code in
+ *     *err_code, see das() and ERRS_NO_MEM.
+ */
+
+    inline size_t
+daa_plan_init(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    daa_plan *plan)
+{
+    unsigned int i;
+    size_t k;
+    char *scratch;
+    char *data_ptr;
+    char *ptr_ptr;
+    ptrdiff_t *t;
+
+
+    plan->tmpl = NULL;
+    if ( geom(data_size, num_dim, dim, layout, &plan->g, err_code) < 0 )
+    {
+        return 0;
+    }
+    plan->data_size = data_size;
+    plan->num_dim = num_dim;
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        plan->dim[i] = dim[i];
+        plan->st[i] = st[i];
+    }
+    plan->dist = 0;
+    if ( plan->g.ptr_bytes == 0 )
+    {
+        return plan->g.size;
+    }
+
+    /* a scratch block aligned for both areas, placed as an aligned block is */
+    scratch = (char *) daa_alloc(plan->g.size, (plan->g.align > plan->g.entry_size) ?
+        plan->g.align : plan->g.entry_size);
+    plan->tmpl = (char *) malloc(plan->g.ptr_bytes);
+    if ( scratch == NULL || plan->tmpl == NULL )
+    {
+        daa_free(scratch);
+        free(plan->tmpl);
+        plan->tmpl = NULL;
+        *err_code = ERRS_NO_MEM;
+        return 0;
+    }
+    daa(data_size, num_dim, dim, st, layout, err_code, scratch, NULL);
+    blk_place(scratch, &plan->g, &data_ptr, &ptr_ptr);
+    plan->dist = ptr_ptr - data_ptr;
+    memcpy(plan->tmpl, ptr_ptr, plan->g.ptr_bytes);
+    daa_free(scratch);
+
+    if ( !plan->g.rel )
+    {
+        t = (ptrdiff_t *) plan->tmpl;
+        for ( k = 0 ; k < plan->g.ptr_count ; k++ )
+        {
+            t[k] = ((char **) plan->tmpl)[k] - ptr_ptr;
+        }
+    }
+
+    return plan->g.size;
+}
+
+/*
+ * daa_plan_build:
+ *     daa() for a plan.  the pointer area is the template with the address
+ *     of the pointer area added to every entry, one sequential pass with no
+ *     per pointer calculation, or for the base relative layouts a memcpy()
+ *     of the template.  a block that is not aligned to the layout align and
+ *     sizeof(char *) may place its areas differently from the template, its
+ *     pointers are then built as daa() builds them.  a plan may be used by
+ *     several threads at once.
+ *
+ * Arguments:
+ *     const daa_plan *plan
+ *        the plan, from daa_plan_init().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space, daa_plan_init() bytes long.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ * Returns:
+ *     the daa() array pointer, or NULL and ERRS_INV_ALIGN in *err_code, see
+ *     daa().
+ */
+
+    inline void *
+daa_plan_build(
+    const daa_plan *plan,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr)
+{
+    const daa_geom *g = &plan->g;
+    char *data_ptr;
+    char *ptr_ptr;
+    char **p;
+    const ptrdiff_t *t;
+    size_t k;
+
+
+    if ( g->rel && ((size_t) base_ptr % g->align != 0 ||
+        (size_t) base_ptr % g->entry_size != 0) )
+    {
+        *err_code = ERRS_INV_ALIGN;
+        return NULL;
+    }
+    blk_place(base_ptr, g, &data_ptr, &ptr_ptr);
+
+    if ( !init_skip(g, init_ptr, plan->data_size) )
+    {
+        blk_fill(data_ptr, plan->data_size, plan->num_dim, (size_t *) plan->dim, g,
+            init_ptr, 0, plan->dim[0]);
+    }
+
+    if ( g->rel )
+    {
+        memcpy(ptr_ptr, plan->tmpl, g->ptr_bytes);
+    }
+    else if ( g->ptr_bytes != 0 && ptr_ptr - data_ptr == plan->dist )
+    {
+        p = (char **) ptr_ptr;
+        t = (const ptrdiff_t *) plan->tmpl;
+        for ( k = 0 ; k < g->ptr_count ; k++ )
+        {
+            p[k] = ptr_ptr + t[k];
+        }
+    }
+    else if ( g->ptr_bytes != 0 )
+    {
+        ptr_rows(plan->data_size, g->pitch, plan->num_dim, data_ptr, ptr_ptr,
+            (size_t *) plan->dim, (ptrdiff_t *) plan->st, (size_t *) g->dp, 0, 0,
+            g->dp[0]);
+    }
+
+    return blk_top(plan->data_size, plan->num_dim, (ptrdiff_t *) plan->st, g,
+        data_ptr, ptr_ptr);
+}
+
+/*
+ * daa_plan_free:
+ *     release the template of a plan.  a released or failed plan is
+ *     ignored.
+ *
+ * Arguments:
+ *     daa_plan *plan
+ *        the plan.
+ */
+
+    inline void
+daa_plan_free(
+    daa_plan *plan)
+{
+    free(plan->tmpl);
+    plan->tmpl = NULL;
+}
+
+/*
+ * daa_arena:
+ *     a fixed buffer arena for daa() blocks, filled in by daa_arena_init().
+ *     it never calls malloc(), so it serves targets that may not allocate
+ *     after startup.  blocks are carved from the buffer in power of 2 size
+ *     classes, headers included, and a released block goes on the free
+ *     list of its class for the next request of that class.  allocation
+ *     and release are bounded time, at most one pass over the bits of a
+ *     size_t and no search of the lists.  the members may be read.
+ */
+
+struct daa_arena
+{
+    char *buf;          /* start of the buffer, ARENA_ALIGN aligned */
+    size_t size;        /* usable byte size of the buffer */
+    size_t top;         /* bytes of the buffer carved into blocks */
+    size_t used;        /* bytes of the allocated blocks */
+    size_t high;        /* high water mark of used */
+    size_t map;         /* bit c set if free[c] is not empty */
+    char *free[sizeof(size_t) * CHAR_BIT];  /* free blocks of each class */
+};
+
+/*
+ * daa_arena_init:
+ *     an empty arena over buf.
+ *
+ * Arguments:
+ *     daa_arena *arena
+ *        returned arena.
+ *
+ *     char *buf
+ *        the buffer, for example a static array.
+ *
+ *     size_t size
+ *        byte size of the buffer.
+ */
+
+    inline void
+daa_arena_init(
+    daa_arena *arena,
+    char *buf,
+    size_t size)
+{
+    size_t skip = (ARENA_ALIGN - (size_t) buf % ARENA_ALIGN) % ARENA_ALIGN;
+    unsigned int c;
+
+
+    arena->buf = buf + skip;
+    arena->size = (size > skip) ? size - skip : 0;
+    arena->top = 0;
+    arena->used = 0;
+    arena->high = 0;
+    arena->map = 0;
+    for ( c = 0 ; c < sizeof(size_t) * CHAR_BIT ; c++ )
+    {
+        arena->free[c] = NULL;
+    }
+}
+
+/*
+ * daa_arena_alloc:
+ *     allocate size bytes, ARENA_ALIGN aligned, from the arena.  the block
+ *     is the smallest power of 2 that holds size and the ARENA_ALIGN byte
+ *     header.  it is a free block of that class, else new space, else a
+ *     free block of the smallest larger class that has one.
+ *
+ * Arguments:
+ *     daa_arena *arena
+ *        the arena.
+ *
+ *     size_t size
+ *        number of bytes, usually from das().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     the space, or NULL and ERRS_NO_MEM in *err_code if the arena can not
+ *     hold it.
+ */
+
+    inline char *
+daa_arena_alloc(
+    daa_arena *arena,
+    size_t size,
+    int *err_code)
+{
+    unsigned int c;
+    size_t m;
+    char *b;
+
+
+    /* the size class, a block of 2^c bytes */
+    for ( c = 5 ; c < sizeof(size_t) * CHAR_BIT - 1 ; c++ )
+    {
+        if ( ((size_t) 1 << c) - ARENA_ALIGN >= size )
+        {
+            break;
+        }
+    }
+    if ( ((size_t) 1 << c) - ARENA_ALIGN < size || ((size_t) 1 << c) > arena->size )
+    {
+        *err_code = ERRS_NO_MEM;
+        return NULL;
+    }
+
+    m = arena->map >> c;
+    if ( (m & 1) == 0 && arena->size - arena->top >= ((size_t) 1 << c) )
+    {
+        b = arena->buf + arena->top;
+        arena->top += (size_t) 1 << c;
+        ((size_t *) b)[0] = c;
+    }
+    else if ( m != 0 )
+    {
+        /* the lowest class >= c with a free block */
+        for ( ; (m & 1) == 0 ; m >>= 1 )
+        {
+            c++;
+        }
+        b = arena->free[c];
+        arena->free[c] = ((char **) b)[1];
+        if ( arena->free[c] == NULL )
+        {
+            arena->map &= ~((size_t) 1 << c);
+        }
+    }
+    else
+    {
+        *err_code = ERRS_NO_MEM;
+        return NULL;
+    }
+
+    arena->used += (size_t) 1 << c;
+    if ( arena->used > arena->high )
+    {
+        arena->high = arena->used;
+    }
+
+    return b + ARENA_ALIGN;
+}
+
+/*
+ * daa_arena_free:
+ *     return space from daa_arena_alloc() to the arena.  a NULL ptr is
+ *     ignored.
+ *
+ * Arguments:
+ *     daa_arena *arena
+ *        the arena.
+ *
+ *     char *ptr
+ *        the space.
+ */
+
+    inline void
+daa_arena_free(
+    daa_arena *arena,
+    char *ptr)
+{
+    char *b;
+    size_t c;
+
+
+    if ( ptr == NULL )
+    {
+        return;
+    }
+    b = ptr - ARENA_ALIGN;
+    c = ((size_t *) b)[0];
+    ((char **) b)[1] = arena->free[c];
+    arena->free[c] = b;
+    arena->map |= (size_t) 1 << c;
+    arena->used -= (size_t) 1 << c;
+}
+
+/*
+ * daa_arena_daa:
+ *     das()/daa_arena_alloc()/daa() in one call.  an array whose das()
+ *     size the arena can not hold is refused.
+ *
+ * Arguments:
+ *     daa_arena *arena
+ *        the arena.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code, char *init_ptr
+ *        see daa().
+ *
+ *     char **base_ptr
+ *        returned space of the array, to give to daa_arena_free().
+ *
+ * Returns:
+ *     the daa() array pointer, or NULL and an error code in *err_code, see
+ *     das(), daa() and ERRS_NO_MEM.
+ */
+
+    inline void *
+daa_arena_daa(
+    daa_arena *arena,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *init_ptr,
+    char **base_ptr)
+{
+    size_t size;
+    void *array;
+
+
+    *base_ptr = NULL;
+    size = das(data_size, num_dim, dim, layout, err_code);
+    if ( size == 0 )
+    {
+        return NULL;
+    }
+    *base_ptr = daa_arena_alloc(arena, size, err_code);
+    if ( *base_ptr == NULL )
+    {
+        return NULL;
+    }
+
+    array = daa(data_size, num_dim, dim, st, layout, err_code, *base_ptr, init_ptr);
+    if ( array == NULL )
+    {
+        daa_arena_free(arena, *base_ptr);
+        *base_ptr = NULL;
+    }
+
+    return array;
+}
+
+} // daa namespace
+
+#endif  // DAA_HPP
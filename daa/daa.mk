@@ -8,6 +8,8 @@ if [ "$1" == 'clean' ]
 then
     rm -f daa_test
     rm -f daa_test.results
+    rm -f daa_bench
+    rm -f daa_bench.results
     exit
 fi
 
@@ -19,8 +21,22 @@ CC="g++"
 O=g
 #O=O
 
+# compile/run benchmark program
+if [ "$1" == 'bench' ]
+then
+    $CC -O2 -std=c++17 -pedantic -Wall -pthread -I. -o daa_bench test/daa_bench.cpp
+    ./daa_bench 2> daa_bench.results
+    exit
+fi
+
+# check daa.hpp, daa_mmap.hpp and daa_file.hpp alone still compile as C++98, daa_array.hpp as C++11
+$CC -ansi -pedantic -Wall -I. -fsyntax-only -x c++ daa.hpp
+$CC -ansi -pedantic -Wall -I. -fsyntax-only -x c++ daa_mmap.hpp
+$CC -ansi -pedantic -Wall -I. -fsyntax-only -x c++ daa_file.hpp
+$CC -std=c++11 -pedantic -Wall -I. -fsyntax-only -x c++ daa_array.hpp
+
 # compile test program
-$CC -$O -ansi -pedantic -Wall -I. -o daa_test test/daa_test.cpp
+$CC -$O -std=c++17 -pedantic -Wall -pthread -I. -o daa_test test/daa_test.cpp
 
 # run test program
 ./daa_test 2> daa_test.results
@@ -0,0 +1,625 @@
+//  daa_array.hpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#ifndef DAA_ARRAY_HPP
+#define DAA_ARRAY_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+#include "daa.hpp"
+
+namespace Daa
+{
+
+/*
+ *==================================================================================================
+ * File: daa_array.hpp
+ *
+ * Description:
+ *     daa_array<T, N> is a typed, rank N owner of a das()/A::allocate()/daa()
+ *     block.  the block has exactly the daa() layout, so get() returns the
+ *     same T** ...* pointer daa() would, and a[i][j]...[k] compiles to the
+ *     same loads as the raw pointer.  at(i, j, ..., k) is the same access
+ *     with the subscripts as arguments.  the block is freed by the
+ *     destructor.  daa_array is move only.
+ *
+ *     because the rank is a compile time constant the size calculation and
+ *     the pointer construction loops have constant trip counts and use
+ *     N element arrays, not MAX_DIM ones.
+ *
+ *     T must be trivially copyable, the init value is copied bytewise and
+ *     no constructors or destructors are run.
+ *
+ *     the block is allocated by the allocator A, daa_malloc by default.
+ *     with C++17 daa_pmr allocates from a std::pmr::memory_resource, for
+ *     example a std::pmr::monotonic_buffer_resource arena that releases
+ *     every array of a request at once.  the block is the exact das()
+ *     size, allocated with the requested alignment, which aligns the data
+ *     area.
+ *
+ *     daa_typed_view<T, N> is a typed daa_attach() view of a position
+ *     independent block, at(i, j, ..., k) resolves the base relative
+ *     offsets.
+ *
+ *     requires C++11, daa_pmr C++17.
+ *
+ * Examples:
+ *     see daa_test.cpp
+ *
+ *==================================================================================================
+ */
+
+/*
+ * daa_ptr:
+ *     daa_ptr<T, N>::type is T with N levels of pointer, T** ...*.
+ */
+
+template <class T, std::size_t N>
+struct daa_ptr
+{
+    typedef typename daa_ptr<T, N-1>::type *type;
+};
+
+template <class T>
+struct daa_ptr<T, 0>
+{
+    typedef T type;
+};
+
+/*
+ * daa_index:
+ *     daa_index<T, N>::at(p, i, j, ..., k) is p[i][j]...[k].
+ */
+
+template <class T, std::size_t N>
+struct daa_index
+{
+    template <class I, class... R>
+        static T &
+    at(
+        typename daa_ptr<T, N>::type p,
+        I i,
+        R... r)
+    {
+        return daa_index<T, N-1>::at(p[i], r...);
+    }
+};
+
+template <class T>
+struct daa_index<T, 1>
+{
+    template <class I>
+        static T &
+    at(
+        T *p,
+        I i)
+    {
+        return p[i];
+    }
+};
+
+/*
+ * daa_malloc:
+ *     the default daa_array allocator.  malloc(), or daa_alloc() for an
+ *     alignment malloc() does not guarantee.  an allocator returns NULL on
+ *     failure.
+ */
+
+struct daa_malloc
+{
+        char *
+    allocate(
+        size_t size,
+        size_t align) const
+    {
+        if ( align <= alignof(std::max_align_t) )
+        {
+            return (char *) malloc(size);
+        }
+        return (char *) daa_alloc(size, align);
+    }
+
+        void
+    deallocate(
+        char *p,
+        size_t,
+        size_t align) const
+    {
+        if ( align <= alignof(std::max_align_t) )
+        {
+            free(p);
+            return;
+        }
+        daa_free(p);
+    }
+};
+
+#if __cplusplus >= 201703L
+
+/*
+ * daa_pmr:
+ *     a daa_array allocator that allocates from a std::pmr::memory_resource,
+ *     the default resource if none is given.  the resource must outlive
+ *     the arrays.
+ */
+
+struct daa_pmr
+{
+    std::pmr::memory_resource *res;  /* the memory resource */
+
+    daa_pmr(
+        std::pmr::memory_resource *r = std::pmr::get_default_resource())
+        : res(r)
+    {
+    }
+
+        char *
+    allocate(
+        size_t size,
+        size_t align) const
+    {
+        try
+        {
+            return (char *) res->allocate(size, align);
+        }
+        catch ( const std::bad_alloc & )
+        {
+            return NULL;
+        }
+    }
+
+        void
+    deallocate(
+        char *p,
+        size_t size,
+        size_t align) const
+    {
+        res->deallocate(p, size, align);
+    }
+};
+
+#endif
+
+template <class T, std::size_t N, class A = daa_malloc>
+class daa_array
+{
+    static_assert(N > 0 && N <= MAX_DIM, "daa_array: invalid rank");
+    static_assert(std::is_trivially_copyable<T>::value,
+        "daa_array: T must be trivially copyable");
+
+public:
+
+    /* T** ...*, N levels */
+    typedef typename daa_ptr<T, N>::type pointer;
+
+    /* type of a[i], T** ...* with N-1 levels, or T & for N of 1 */
+    typedef typename std::conditional<N == 1, T &,
+        typename daa_ptr<T, N-1>::type>::type reference;
+
+    /*
+     * daa_array:
+     *     an empty array, no block.
+     */
+
+    daa_array()
+        : ptr_(NULL), mem_(NULL), size_(0), align_(0), dim_(), st_(), alloc_()
+    {
+    }
+
+    /*
+     * daa_array:
+     *     allocate the array with A() and build it with the daa()
+     *     layout.  on failure the array is empty and *err_code is set.
+     *
+     * Arguments:
+     *     const size_t (&dim)[N]
+     *        the dimensions of the array.
+     *
+     *     const ptrdiff_t (&st)[N]
+     *        the start subscripts of each dimension, may be negative.
+     *
+     *     const T *init_ptr
+     *        initialization value, or NULL for no initialization.
+     *
+     *     int *err_code
+     *        index to returned error code string in daa_errs[], or NULL.
+     *        see das() and ERRS_NO_MEM.
+     */
+
+    daa_array(
+        const size_t (&dim)[N],
+        const ptrdiff_t (&st)[N],
+        const T *init_ptr = NULL,
+        int *err_code = NULL)
+        : daa_array(dim, st, A(), 0, init_ptr, err_code)
+    {
+    }
+
+    /*
+     * daa_array:
+     *     allocate the array with alloc, aligned to align, and build it
+     *     with the daa() layout.  on failure the array is empty and
+     *     *err_code is set.
+     *
+     * Arguments:
+     *     const size_t (&dim)[N], const ptrdiff_t (&st)[N]
+     *        the dimensions and start subscripts of the array.
+     *
+     *     const A &alloc
+     *        the allocator, copied into the array, which frees the block
+     *        with it.
+     *
+     *     size_t align
+     *        alignment of the block and so of the data area, 0 for
+     *        alignof(std::max_align_t), else a power of 2.
+     *
+     *     const T *init_ptr, int *err_code
+     *        see above.  ERRS_INV_ALIGN - align not a power of 2.
+     */
+
+    daa_array(
+        const size_t (&dim)[N],
+        const ptrdiff_t (&st)[N],
+        const A &alloc,
+        size_t align = 0,
+        const T *init_ptr = NULL,
+        int *err_code = NULL)
+        : ptr_(NULL), mem_(NULL), size_(0), align_(0), dim_(), st_(), alloc_(alloc)
+    {
+        int err = 0;
+        size_t dp[N];
+        size_t k;
+
+
+        for ( k = 0 ; k < N ; k++ )
+        {
+            dim_[k] = dim[k];
+            st_[k] = st[k];
+        }
+
+        align_ = (align > 0) ? align : alignof(std::max_align_t);
+        if ( (align_ & (align_ - 1)) != 0 )
+        {
+            err = ERRS_INV_ALIGN;
+        }
+        else
+        {
+            size_ = shape(dp, &err);
+        }
+        if ( size_ != 0 )
+        {
+            mem_ = alloc_.allocate(size_, align_);
+            if ( mem_ == NULL )
+            {
+                err = ERRS_NO_MEM;
+            }
+        }
+
+        if ( mem_ == NULL )
+        {
+            size_ = 0;
+            if ( err_code != NULL )
+            {
+                *err_code = err;
+            }
+            return;
+        }
+
+        if ( init_ptr != NULL )
+        {
+            data_fill(mem_, dp[N-1], sizeof(T), (char *) init_ptr);
+        }
+
+        ptr_ = (pointer) build(mem_, dp);
+    }
+
+    daa_array(const daa_array &) = delete;
+    daa_array &operator=(const daa_array &) = delete;
+
+    daa_array(
+        daa_array &&a)
+        : ptr_(a.ptr_), mem_(a.mem_), size_(a.size_), align_(a.align_), dim_(), st_(),
+        alloc_(a.alloc_)
+    {
+        take(a);
+    }
+
+        daa_array &
+    operator=(
+        daa_array &&a)
+    {
+        if ( this != &a )
+        {
+            release();
+            ptr_ = a.ptr_;
+            mem_ = a.mem_;
+            size_ = a.size_;
+            align_ = a.align_;
+            alloc_ = a.alloc_;
+            take(a);
+        }
+        return *this;
+    }
+
+    ~daa_array()
+    {
+        release();
+    }
+
+    /*
+     * operator[]:
+     *     the i'th slice, exactly as the raw pointer's [i].
+     */
+
+        reference
+    operator[](
+        ptrdiff_t i) const
+    {
+        return ptr_[i];
+    }
+
+    /*
+     * at:
+     *     the element a[i][j]...[k], N subscripts.
+     */
+
+    template <class... I>
+        T &
+    at(
+        I... i) const
+    {
+        static_assert(sizeof...(I) == N, "daa_array: at() needs N subscripts");
+        return daa_index<T, N>::at(ptr_, i...);
+    }
+
+    /* the raw T** ...* pointer daa() would return, NULL if empty */
+    pointer get() const { return ptr_; }
+
+    /* the start of the allocated block, NULL if empty */
+    char *base() const { return mem_; }
+
+    /* the byte size of the allocated block, das() */
+    size_t size() const { return size_; }
+
+    /* dimension k */
+    size_t dim(size_t k) const { return dim_[k]; }
+
+    /* start subscript of dimension k */
+    ptrdiff_t st(size_t k) const { return st_[k]; }
+
+    /* true if not empty */
+    explicit operator bool() const { return ptr_ != NULL; }
+
+private:
+
+    pointer ptr_;     /* the daa() pointer */
+    char *mem_;       /* the allocated block */
+    size_t size_;     /* byte size of the block */
+    size_t align_;    /* alignment of the block */
+    size_t dim_[N];   /* dimensions */
+    ptrdiff_t st_[N]; /* start subscripts */
+    A alloc_;         /* the allocator of the block */
+
+    /*
+     * release:
+     *     free the block, if any.
+     */
+
+        void
+    release()
+    {
+        if ( mem_ != NULL )
+        {
+            alloc_.deallocate(mem_, size_, align_);
+        }
+    }
+
+    /*
+     * take:
+     *     copy the shape of a moved from array and leave it empty.
+     */
+
+        void
+    take(
+        daa_array &a)
+    {
+        size_t k;
+
+
+        for ( k = 0 ; k < N ; k++ )
+        {
+            dim_[k] = a.dim_[k];
+            st_[k] = a.st_[k];
+        }
+        a.ptr_ = NULL;
+        a.mem_ = NULL;
+        a.size_ = 0;
+    }
+
+    /*
+     * shape:
+     *     das() for rank N.  set dp[] and return the block size, or 0 and
+     *     set *err_code.
+     */
+
+        size_t
+    shape(
+        size_t *dp,
+        int *err_code) const
+    {
+        size_t k;
+        size_t ptrs = 1;  /* pointers plus the alignment slack */
+
+
+        for ( k = 0 ; k < N ; k++ )
+        {
+            if ( dim_[k] == 0 )
+            {
+                *err_code = ERRS_INV_DIM;
+                return 0;
+            }
+            if ( k > 0 && dp[k-1] > ((size_t) -1) / dim_[k] )
+            {
+                *err_code = ERRS_SIZE_OVERFLOW;
+                return 0;
+            }
+            dp[k] = (k == 0) ? dim_[k] : dp[k-1] * dim_[k];
+        }
+
+        for ( k = 0 ; k + 1 < N ; k++ )
+        {
+            if ( dp[k] > ((size_t) -1) / sizeof(char *) - ptrs )
+            {
+                *err_code = ERRS_SIZE_OVERFLOW;
+                return 0;
+            }
+            ptrs += dp[k];
+        }
+
+        if ( dp[N-1] > ((size_t) -1) / sizeof(T) ||
+            dp[N-1] * sizeof(T) > ((size_t) -1) - ptrs * sizeof(char *) )
+        {
+            *err_code = ERRS_SIZE_OVERFLOW;
+            return 0;
+        }
+
+        return dp[N-1] * sizeof(T) + ptrs * sizeof(char *);
+    }
+
+    /*
+     * build:
+     *     daa() pointer construction for rank N.
+     */
+
+        char *
+    build(
+        char *base_ptr,
+        size_t *dp)
+    {
+        char *ptr_ptr = ptr_start(base_ptr, dp[N-1] * sizeof(T));
+
+        ptr_rows(sizeof(T), dim_[N-1] * sizeof(T), N, base_ptr, ptr_ptr, dim_,
+            st_, dp, 0, 0, dim_[0]);
+
+        return ptr_top(sizeof(T), N, base_ptr, ptr_ptr, st_);
+    }
+};
+
+/*
+ * daa_typed_view:
+ *     a typed, rank N daa_attach() view of a position independent(DAA_OFF32
+ *     or DAA_REL) block, for example one mapped from shared memory or a
+ *     file at an address other than the one daa() built it at.  the view
+ *     does not own the block.
+ */
+
+template <class T, std::size_t N>
+class daa_typed_view
+{
+    static_assert(N > 0 && N <= MAX_DIM, "daa_typed_view: invalid rank");
+
+public:
+
+    /*
+     * daa_typed_view:
+     *     an empty view, no block.
+     */
+
+    daa_typed_view()
+        : view_()
+    {
+    }
+
+    /*
+     * daa_typed_view:
+     *     attach to the block at base_ptr.  on failure the view is empty and
+     *     *err_code is set.
+     *
+     * Arguments:
+     *     char *base_ptr
+     *        the address of the block in this process.
+     *
+     *     const size_t (&dim)[N], const ptrdiff_t (&st)[N]
+     *        the dimensions and start subscripts the block was built with.
+     *
+     *     const daa_layout &layout
+     *        the layout the block was built with.
+     *
+     *     int *err_code
+     *        index to returned error code string in daa_errs[], or NULL.
+     *        see daa_attach().
+     */
+
+    daa_typed_view(
+        char *base_ptr,
+        const size_t (&dim)[N],
+        const ptrdiff_t (&st)[N],
+        const daa_layout &layout,
+        int *err_code = NULL)
+        : view_()
+    {
+        int err = 0;
+        size_t d[N];
+        ptrdiff_t s[N];
+        size_t k;
+
+
+        for ( k = 0 ; k < N ; k++ )
+        {
+            d[k] = dim[k];
+            s[k] = st[k];
+        }
+
+        if ( daa_attach(sizeof(T), N, d, s, &layout, &err, base_ptr, &view_) == NULL )
+        {
+            view_ = daa_view();
+            if ( err_code != NULL )
+            {
+                *err_code = err;
+            }
+        }
+    }
+
+    /*
+     * at:
+     *     the element a[i][j]...[k], N subscripts.
+     */
+
+    template <class... I>
+        T &
+    at(
+        I... i) const
+    {
+        static_assert(sizeof...(I) == N, "daa_typed_view: at() needs N subscripts");
+        const ptrdiff_t idx[N] = {ptrdiff_t(i)...};
+
+        return *(T *) daa_view_at(&view_, idx);
+    }
+
+    /* the untyped view */
+    const daa_view &view() const { return view_; }
+
+    /* true if attached */
+    explicit operator bool() const { return view_.base != NULL; }
+
+private:
+
+    daa_view view_;  /* the daa_attach() view */
+};
+
+} // daa namespace
+
+#endif  // DAA_ARRAY_HPP
@@ -0,0 +1,2635 @@
+//  daa_file.hpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#ifndef DAA_FILE_HPP
+#define DAA_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "daa.hpp"
+
+namespace Daa
+{
+
+const int DAA_FILE_READ = 0;         /* map the file read only */
+const int DAA_FILE_COW = 1;          /* map the file copy on write, writes stay private */
+const int DAA_FILE_WRITE = 2;        /* map the file shared, writes go to the file */
+const unsigned int FILE_IOV = 64;    /* rows written by one writev() */
+const size_t NPY_ALIGN = 64;         /* .npy header length multiple */
+const size_t NPY_HEAD_MAX = 8192;    /* longest .npy header daa_npy_write() writes */
+const size_t NPY_DESCR = 16;         /* longest .npy dtype descr, with the terminating 0 */
+const size_t SAVE_ALIGN = 64;        /* daa_save() header length multiple */
+const size_t SAVE_HEAD_MAX = (88 + 16 * MAX_DIM + SAVE_ALIGN - 1) / SAVE_ALIGN * SAVE_ALIGN;
+
+/*
+ *==================================================================================================
+ * File: daa_file.hpp
+ *
+ * Description:
+ *     arrays in files.  daa_npy_map() maps a NumPy .npy file and
+ *     daa_raw_map() a headerless raw file, and both build the pointers of
+ *     a daa() array over the mapped data in a small separate pointer area
+ *     (see daa_adopt()).  the data is not read or copied, its pages are
+ *     read in by the system as they are used and are shared with the page
+ *     cache, so a mapped array costs no more memory than its pointers.
+ *     the file is mapped read only(DAA_FILE_READ), copy on write
+ *     (DAA_FILE_COW), where writes change the array but not the file, or
+ *     shared(DAA_FILE_WRITE), where writes change the file.
+ *     release the array with daa_file_unmap().
+ *
+ *     daa_npy_write() and daa_raw_write() stream an array, or a view of
+ *     one, described by a daa_desc(see dad() and dad_sub()) to a file.
+ *     the rows are written straight from the array with writev(), which
+ *     joins adjacent rows, so a dense array is written with one call and
+ *     no staging buffer.
+ *
+ *     only .npy files of a single native byte order dtype in C(row major)
+ *     order are read, the descr of the file is kept in the daa_file.
+ *
+ *     daa_save() saves an array in a file of its own format, a header with
+ *     the shape, start subscripts, layout and a checksum of the data, and
+ *     the data area, written with one pwritev().  das_load() reads the
+ *     header and returns the das() size of the block, and daa_load() reads
+ *     the data straight into the data area of the block, checks the
+ *     checksum and builds the pointers.
+ *
+ *     daa_slabs_open() opens a raw file too large to map or read whole as
+ *     an array in slabs of dim 0 rows.  daa_slabs_get() maps the slab holding a
+ *     row on use and returns an array indexed with the global subscripts,
+ *     at most max_slabs slabs are mapped at once, the least recently used
+ *     one is unmapped and its pages dropped from the page cache, and the
+ *     next slab is read ahead when the rows are walked in order.
+ *
+ *     daa_checkpoint() checkpoints an array to a daa_save() file without
+ *     stopping the caller.  it forks, the child writes a copy on write
+ *     snapshot of the array while the caller goes on changing it.  the
+ *     changes are tracked in a daa_dirty by daa_dirty_set(), the write
+ *     barrier called with every write, in units of innermost rows, and a
+ *     checkpoint writes only the changed units.  the checkpoints alternate
+ *     between two files and the path is a symbolic link renamed to the
+ *     last whole one, so a checkpoint cut short leaves the one before.
+ *
+ *     requires a POSIX system.
+ *
+ * Examples:
+ *     see daa_test.cpp
+ *
+ *==================================================================================================
+ */
+
+/*
+ * daa_file:
+ *     a mapped file array, filled in by daa_npy_map() and daa_raw_map().
+ */
+
+struct daa_file
+{
+    char *map;              /* start of the file mapping */
+    size_t map_size;        /* byte length of the mapping */
+    char *data;             /* the array data in the mapping */
+    char *ptrs;             /* the pointer area, malloc() */
+    size_t data_size;       /* size of the basic array data object */
+    unsigned int num_dim;   /* number of array dimensions */
+    size_t dim[MAX_DIM];    /* dimensions */
+    char descr[NPY_DESCR];  /* the .npy dtype, such as "<f8", empty for raw */
+};
+
+/*
+ * npy_size:
+ *     the element size of a .npy dtype descr, a byte order character, a
+ *     kind character and a count, such as "<f8" or "|u1".  a unicode
+ *     count('U') is in 4 byte characters.
+ *
+ * Arguments:
+ *     const char *descr
+ *        the dtype descr.
+ *
+ * Returns:
+ *     the size in bytes, or 0 for a descr of another form or of the byte
+ *     order not of this machine.
+ */
+
+    static size_t
+npy_size(
+    const char *descr)
+{
+    unsigned short one = 1;
+    char native = (*(char *) &one == 1) ? '<' : '>';
+    size_t size = 0;
+    const char *p;
+
+
+    if ( descr[0] != native && descr[0] != '|' && descr[0] != '=' )
+    {
+        return 0;
+    }
+    if ( descr[1] == '\0' )
+    {
+        return 0;
+    }
+    for ( p = descr + 2 ; *p >= '0' && *p <= '9' ; p++ )
+    {
+        if ( size > (((size_t) -1) - 9) / 10 )
+        {
+            return 0;
+        }
+        size = 10 * size + (size_t) (*p - '0');
+    }
+    if ( *p != '\0' && *p != '[' )
+    {
+        return 0;
+    }
+    if ( descr[1] == 'U' )
+    {
+        size = (size > ((size_t) -1) / 4) ? 0 : 4 * size;
+    }
+
+    return size;
+}
+
+/*
+ * npy_key:
+ *     the value of key in a .npy header dict, after the colon and spaces.
+ *
+ * Arguments:
+ *     const char *h, const char *end
+ *        the header dict.
+ *
+ *     const char *key
+ *        the quoted key, such as "'shape'".
+ *
+ * Returns:
+ *     the start of the value, or NULL if the key is not in the dict or
+ *     has no value.
+ */
+
+    static const char *
+npy_key(
+    const char *h,
+    const char *end,
+    const char *key)
+{
+    size_t n = strlen(key);
+    const char *q;
+
+
+    q = h;
+    while ( q + n <= end && memcmp(q, key, n) != 0 )
+    {
+        q++;
+    }
+    if ( q + n > end )
+    {
+        return NULL;
+    }
+    q += n;
+    while ( q < end && (*q == ':' || *q == ' ') )
+    {
+        q++;
+    }
+
+    return (q < end) ? q : NULL;
+}
+
+/*
+ * npy_head:
+ *     parse the header of a .npy file, the magic string, the version, the
+ *     header length and the header dict with the descr, fortran_order and
+ *     shape keys.  a shape of () is taken as one element.
+ *
+ * Arguments:
+ *     const char *p
+ *        the start of the file.
+ *
+ *     size_t len
+ *        the file length.
+ *
+ *     daa_file *file
+ *        returned data_size, num_dim, dim and descr.
+ *
+ * Returns:
+ *     the offset of the data in the file, or 0 for a file that is not a
+ *     .npy file daa_npy_map() reads.
+ */
+
+    static size_t
+npy_head(
+    const char *p,
+    size_t len,
+    daa_file *file)
+{
+    size_t hlen;    /* header dict length */
+    size_t off;     /* dict offset */
+    const char *h;
+    const char *end;
+    const char *q;
+    size_t i;
+
+
+    if ( len < 10 || memcmp(p, "\x93NUMPY", 6) != 0 )
+    {
+        return 0;
+    }
+    if ( p[6] == 1 )
+    {
+        hlen = (size_t) (unsigned char) p[8] | (size_t) (unsigned char) p[9] << 8;
+        off = 10;
+    }
+    else if ( (p[6] == 2 || p[6] == 3) && len >= 12 )
+    {
+        hlen = (size_t) (unsigned char) p[8] | (size_t) (unsigned char) p[9] << 8 |
+            (size_t) (unsigned char) p[10] << 16 | (size_t) (unsigned char) p[11] << 24;
+        off = 12;
+    }
+    else
+    {
+        return 0;
+    }
+    if ( hlen > len - off )
+    {
+        return 0;
+    }
+    h = p + off;
+    end = h + hlen;
+
+    /* 'descr': '<f8' */
+    q = npy_key(h, end, "'descr'");
+    if ( q == NULL || *q++ != '\'' )
+    {
+        return 0;
+    }
+    for ( i = 0 ; q < end && *q != '\'' && i + 1 < sizeof(file->descr) ; i++ )
+    {
+        file->descr[i] = *q++;
+    }
+    file->descr[i] = '\0';
+    if ( q >= end || *q != '\'' || (file->data_size = npy_size(file->descr)) == 0 )
+    {
+        return 0;
+    }
+
+    /* 'fortran_order': False */
+    q = npy_key(h, end, "'fortran_order'");
+    if ( q == NULL || q + 5 > end || memcmp(q, "False", 5) != 0 )
+    {
+        return 0;
+    }
+
+    /* 'shape': (2, 3, 4) */
+    q = npy_key(h, end, "'shape'");
+    if ( q == NULL || *q++ != '(' )
+    {
+        return 0;
+    }
+    file->num_dim = 0;
+    while ( q < end && *q != ')' )
+    {
+        if ( *q >= '0' && *q <= '9' )
+        {
+            if ( file->num_dim == MAX_DIM )
+            {
+                return 0;
+            }
+            file->dim[file->num_dim] = 0;
+            for ( ; q < end && *q >= '0' && *q <= '9' ; q++ )
+            {
+                if ( file->dim[file->num_dim] > (((size_t) -1) - 9) / 10 )
+                {
+                    return 0;
+                }
+                file->dim[file->num_dim] = 10 * file->dim[file->num_dim] +
+                    (size_t) (*q - '0');
+            }
+            file->num_dim++;
+        }
+        else if ( *q == ',' || *q == ' ' || *q == 'L' )
+        {
+            q++;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    if ( q >= end )
+    {
+        return 0;
+    }
+    if ( file->num_dim == 0 )
+    {
+        file->num_dim = 1;
+        file->dim[0] = 1;
+    }
+
+    return off + hlen;
+}
+
+/*
+ * mode_map:
+ *     map len bytes at offset off of the file open on fd for mode.
+ *
+ * Arguments:
+ *     int fd
+ *        the file descriptor, open for mode, see mode_open().
+ *
+ *     size_t off
+ *        the file offset, a multiple of the page size.
+ *
+ *     size_t len
+ *        byte length of the mapping.
+ *
+ *     int mode
+ *        DAA_FILE_READ, DAA_FILE_COW or DAA_FILE_WRITE.
+ *
+ * Returns:
+ *     start of the mapping, or NULL with errno set.
+ */
+
+    static char *
+mode_map(
+    int fd,
+    size_t off,
+    size_t len,
+    int mode)
+{
+    void *p;
+
+
+    if ( mode == DAA_FILE_COW )
+    {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) off);
+    }
+    else if ( mode == DAA_FILE_WRITE )
+    {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) off);
+    }
+    else
+    {
+        p = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, (off_t) off);
+    }
+
+    return (p == MAP_FAILED) ? NULL : (char *) p;
+}
+
+/*
+ * mode_open:
+ *     open the file path for mode, read and write for DAA_FILE_WRITE, else
+ *     read only.
+ *
+ * Returns:
+ *     the file descriptor, or -1 with errno set.
+ */
+
+    static int
+mode_open(
+    const char *path,
+    int mode)
+{
+    return open(path, (mode == DAA_FILE_WRITE) ? O_RDWR : O_RDONLY);
+}
+
+/*
+ * file_map:
+ *     map all of the file path for mode.
+ *
+ * Arguments:
+ *     const char *path
+ *        the file.
+ *
+ *     int mode
+ *        DAA_FILE_READ, DAA_FILE_COW or DAA_FILE_WRITE.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_file *file
+ *        returned map and map_size.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set, ERRS_SYS(errno
+ *     tells why) or ERRS_FILE for an empty file.
+ */
+
+    static int
+file_map(
+    const char *path,
+    int mode,
+    int *err_code,
+    daa_file *file)
+{
+    int fd;
+    struct stat sb;
+    char *p;
+
+
+    fd = mode_open(path, mode);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( fstat(fd, &sb) != 0 )
+    {
+        close(fd);
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( sb.st_size <= 0 )
+    {
+        close(fd);
+        *err_code = ERRS_FILE;
+        return -1;
+    }
+
+    p = mode_map(fd, 0, (size_t) sb.st_size, mode);
+    close(fd);
+    if ( p == NULL )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    file->map = p;
+    file->map_size = (size_t) sb.st_size;
+
+    return 0;
+}
+
+/*
+ * file_build:
+ *     build the pointers of the array of file at offset off of the
+ *     mapping.  on failure the mapping is released.
+ *
+ * Arguments:
+ *     size_t off
+ *        the offset of the data in the mapping.
+ *
+ *     ptrdiff_t *st
+ *        the start subscripts, or NULL for all zero.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_file *file
+ *        the mapped file, with data_size, num_dim and dim.
+ *
+ * Returns:
+ *     the array pointer, or NULL and an error code in *err_code, see
+ *     das(), ERRS_NO_MEM and ERRS_FILE.
+ */
+
+    static void *
+file_build(
+    size_t off,
+    ptrdiff_t *st,
+    int *err_code,
+    daa_file *file)
+{
+    ptrdiff_t zero[MAX_DIM];
+    daa_geom g;
+    void *array = NULL;
+    unsigned int i;
+
+
+    if ( st == NULL )
+    {
+        for ( i = 0 ; i < file->num_dim ; i++ )
+        {
+            zero[i] = 0;
+        }
+        st = zero;
+    }
+
+    if ( adopt_geom(file->data_size, file->num_dim, file->dim, NULL, &g, err_code) == 0 )
+    {
+        if ( off > file->map_size || g.data_bytes > file->map_size - off )
+        {
+            *err_code = ERRS_FILE;
+        }
+        else
+        {
+            file->data = file->map + off;
+            file->ptrs = (char *) malloc(das_adopt(file->data_size, file->num_dim,
+                file->dim, NULL, err_code));
+            if ( file->ptrs == NULL )
+            {
+                *err_code = ERRS_NO_MEM;
+            }
+            else
+            {
+                array = daa_adopt(file->data_size, file->num_dim, file->dim, st, NULL,
+                    err_code, file->data, file->ptrs);
+            }
+        }
+    }
+
+    if ( array == NULL )
+    {
+        free(file->ptrs);
+        munmap(file->map, file->map_size);
+        file->map = NULL;
+        file->ptrs = NULL;
+        file->data = NULL;
+    }
+
+    return array;
+}
+
+/*
+ * daa_npy_map:
+ *     map a NumPy .npy file and build the pointers of an array over its
+ *     data.  the shape, element size and descr of the file are returned
+ *     in file.  release the array with daa_file_unmap(), also after a
+ *     failure.
+ *
+ * Arguments:
+ *     const char *path
+ *        the .npy file.
+ *
+ *     ptrdiff_t *st
+ *        the start subscripts, one for each dimension of the file, or NULL
+ *        for all zero.
+ *
+ *     int mode
+ *        DAA_FILE_READ, DAA_FILE_COW or DAA_FILE_WRITE.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_file *file
+ *        returned mapping, shape and descr.
+ *
+ * Returns:
+ *     the array pointer, or NULL and an error code in *err_code, see
+ *     daa_adopt(), ERRS_NO_MEM and ERRS_SYS.
+ *     ERRS_FILE - the file is not a C order, native byte order .npy file,
+ *     or too short for its shape.
+ */
+
+    inline void *
+daa_npy_map(
+    const char *path,
+    ptrdiff_t *st,
+    int mode,
+    int *err_code,
+    daa_file *file)
+{
+    size_t off;
+
+
+    file->map = NULL;
+    file->map_size = 0;
+    file->data = NULL;
+    file->ptrs = NULL;
+
+    if ( file_map(path, mode, err_code, file) < 0 )
+    {
+        return NULL;
+    }
+
+    off = npy_head(file->map, file->map_size, file);
+    if ( off == 0 )
+    {
+        munmap(file->map, file->map_size);
+        file->map = NULL;
+        *err_code = ERRS_FILE;
+        return NULL;
+    }
+
+    return file_build(off, st, err_code, file);
+}
+
+/*
+ * daa_raw_map:
+ *     map a headerless file of raw row major data and build the pointers
+ *     of an array over it.  release the array with daa_file_unmap(), also
+ *     after a failure.
+ *
+ * Arguments:
+ *     const char *path
+ *        the file.
+ *
+ *     size_t offset
+ *        the offset of the data in the file.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st
+ *        see daa().
+ *
+ *     int mode
+ *        DAA_FILE_READ, DAA_FILE_COW or DAA_FILE_WRITE.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_file *file
+ *        returned mapping.
+ *
+ * Returns:
+ *     the array pointer, or NULL and an error code in *err_code, see
+ *     daa_npy_map().
+ */
+
+    inline void *
+daa_raw_map(
+    const char *path,
+    size_t offset,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    int mode,
+    int *err_code,
+    daa_file *file)
+{
+    unsigned int i;
+
+
+    file->map = NULL;
+    file->map_size = 0;
+    file->data = NULL;
+    file->ptrs = NULL;
+    file->descr[0] = '\0';
+    if ( num_dim < 1 || num_dim > MAX_DIM )
+    {
+        *err_code = ERRS_INV_DIMS;
+        return NULL;
+    }
+    file->data_size = data_size;
+    file->num_dim = num_dim;
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        file->dim[i] = dim[i];
+    }
+
+    if ( file_map(path, mode, err_code, file) < 0 )
+    {
+        return NULL;
+    }
+
+    return file_build(offset, st, err_code, file);
+}
+
+/*
+ * daa_file_unmap:
+ *     release an array mapped by daa_npy_map() or daa_raw_map().  the
+ *     daa_file is cleared, a cleared daa_file is ignored.
+ *
+ * Arguments:
+ *     daa_file *file
+ *        the mapped file.
+ */
+
+    inline void
+daa_file_unmap(
+    daa_file *file)
+{
+    if ( file->map != NULL )
+    {
+        munmap(file->map, file->map_size);
+    }
+    free(file->ptrs);
+    file->map = NULL;
+    file->map_size = 0;
+    file->data = NULL;
+    file->ptrs = NULL;
+}
+
+/*
+ * iov_write:
+ *     writev() all of cnt iovecs, again after a short write or a signal.
+ *
+ * Arguments:
+ *     int fd
+ *        the file descriptor.
+ *
+ *     struct iovec *iov
+ *        the iovecs, changed.
+ *
+ *     int cnt
+ *        number of iovecs.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with errno set.
+ */
+
+    static int
+iov_write(
+    int fd,
+    struct iovec *iov,
+    int cnt)
+{
+    ssize_t n;
+
+
+    while ( cnt > 0 )
+    {
+        n = writev(fd, iov, cnt);
+        if ( n < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            return -1;
+        }
+        while ( cnt > 0 && (size_t) n >= iov->iov_len )
+        {
+            n -= (ssize_t) iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if ( cnt > 0 )
+        {
+            iov->iov_base = (char *) iov->iov_base + n;
+            iov->iov_len -= (size_t) n;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * desc_write:
+ *     write the elements of the array of desc to fd in row major order,
+ *     after head_len bytes of head.  the rows, or the elements of a view
+ *     with a step in the last dimension, are gathered FILE_IOV at a time
+ *     into one writev(), and a row that follows the previous one in memory
+ *     is joined to it, so a dense array is one iovec.
+ *
+ * Arguments:
+ *     int fd
+ *        the file descriptor.
+ *
+ *     const char *head, size_t head_len
+ *        bytes written before the elements, head_len may be 0.
+ *
+ *     const daa_desc *desc
+ *        the array.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with errno set.
+ */
+
+    static int
+desc_write(
+    int fd,
+    const char *head,
+    size_t head_len,
+    const daa_desc *desc)
+{
+    struct iovec iov[FILE_IOV];
+    size_t cnt[MAX_DIM];    /* odometer of the row subscripts */
+    unsigned int n = desc->num_dim;
+    unsigned int i;
+    int k = 0;              /* iovecs in use */
+    char *row;              /* the zero subscript address of a row */
+    char *p;
+    size_t run;             /* bytes of one contiguous part of a row */
+    size_t parts;           /* contiguous parts of a row */
+    size_t rows = 1;
+    size_t r, j;
+
+
+    if ( head_len > 0 )
+    {
+        iov[k].iov_base = (char *) head;
+        iov[k].iov_len = head_len;
+        k++;
+    }
+
+    if ( desc->stride[n-1] == (ptrdiff_t) desc->data_size )
+    {
+        run = desc->dim[n-1] * desc->data_size;
+        parts = 1;
+    }
+    else
+    {
+        run = desc->data_size;
+        parts = desc->dim[n-1];
+    }
+
+    row = desc->origin;
+    for ( i = 0 ; i < n ; i++ )
+    {
+        row += desc->st[i] * desc->stride[i];
+        if ( i + 1 < n )
+        {
+            cnt[i] = 0;
+            rows *= desc->dim[i];
+        }
+    }
+
+    for ( r = 0 ; r < rows ; r++ )
+    {
+        for ( j = 0, p = row ; j < parts ; j++, p += desc->stride[n-1] )
+        {
+            if ( k > 0 && (char *) iov[k-1].iov_base + iov[k-1].iov_len == p &&
+                iov[k-1].iov_base != head )
+            {
+                iov[k-1].iov_len += run;
+                continue;
+            }
+            if ( k == (int) FILE_IOV )
+            {
+                if ( iov_write(fd, iov, k) < 0 )
+                {
+                    return -1;
+                }
+                k = 0;
+            }
+            iov[k].iov_base = p;
+            iov[k].iov_len = run;
+            k++;
+        }
+
+        for ( i = n - 1 ; i-- > 0 ; )
+        {
+            row += desc->stride[i];
+            if ( ++cnt[i] < desc->dim[i] )
+            {
+                break;
+            }
+            cnt[i] = 0;
+            row -= (ptrdiff_t) desc->dim[i] * desc->stride[i];
+        }
+    }
+
+    return iov_write(fd, iov, k);
+}
+
+/*
+ * file_write:
+ *     create or truncate the file path and write head and the array of
+ *     desc to it, see desc_write().
+ *
+ * Arguments:
+ *     const char *path
+ *        the file.
+ *
+ *     const char *head, size_t head_len
+ *        bytes written before the elements.
+ *
+ *     const daa_desc *desc
+ *        the array.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set to ERRS_SYS, errno
+ *     tells why.
+ */
+
+    static int
+file_write(
+    const char *path,
+    const char *head,
+    size_t head_len,
+    const daa_desc *desc,
+    int *err_code)
+{
+    int fd;
+    int err;
+
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( desc_write(fd, head, head_len, desc) < 0 )
+    {
+        err = errno;
+        close(fd);
+        errno = err;
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( close(fd) != 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * daa_npy_write:
+ *     write an array, or a view of one, as a NumPy .npy file, the header,
+ *     padded to a multiple of NPY_ALIGN bytes, and the elements in row
+ *     major order.  the array is written in place, see desc_write().
+ *
+ * Arguments:
+ *     const char *path
+ *        the file, created or truncated.
+ *
+ *     const char *descr
+ *        the dtype descr of the elements, such as "<f8" for double on a
+ *        little endian machine.
+ *
+ *     const daa_desc *desc
+ *        the array, from dad() or dad_sub().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set.
+ *     ERRS_INV_REQ_SIZE - descr is not a native byte order dtype of
+ *     desc->data_size bytes.
+ *     ERRS_SYS - a system call failed, errno tells why.
+ */
+
+    inline int
+daa_npy_write(
+    const char *path,
+    const char *descr,
+    const daa_desc *desc,
+    int *err_code)
+{
+    char head[NPY_HEAD_MAX];
+    size_t len;     /* header length so far */
+    size_t hlen;    /* the dict length, with the padding and newline */
+    unsigned int i;
+
+
+    if ( strlen(descr) >= NPY_DESCR ||
+        npy_size(descr) != desc->data_size )
+    {
+        *err_code = ERRS_INV_REQ_SIZE;
+        return -1;
+    }
+
+    len = 10 + (size_t) sprintf(head + 10, "{'descr': '%s', 'fortran_order': False, "
+        "'shape': (", descr);
+    for ( i = 0 ; i < desc->num_dim ; i++ )
+    {
+        len += (size_t) sprintf(head + len, (i + 1 < desc->num_dim || i == 0) ?
+            "%lu," : "%lu", (unsigned long) desc->dim[i]);
+        if ( i + 1 < desc->num_dim )
+        {
+            head[len++] = ' ';
+        }
+    }
+    len += (size_t) sprintf(head + len, "), }");
+
+    /* pad with spaces, end with a newline */
+    hlen = (len + 1 + NPY_ALIGN - 1) / NPY_ALIGN * NPY_ALIGN - 10;
+    memset(head + len, ' ', hlen + 10 - len - 1);
+    head[hlen + 9] = '\n';
+    memcpy(head, "\x93NUMPY\x01\x00", 8);
+    head[8] = (char) (hlen & 0xff);
+    head[9] = (char) (hlen >> 8);
+
+    return file_write(path, head, hlen + 10, desc, err_code);
+}
+
+/*
+ * daa_raw_write:
+ *     write the elements of an array, or a view of one, in row major
+ *     order to a headerless file, see desc_write().
+ *
+ * Arguments:
+ *     const char *path
+ *        the file, created or truncated.
+ *
+ *     const daa_desc *desc
+ *        the array, from dad() or dad_sub().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set to ERRS_SYS, errno
+ *     tells why.
+ */
+
+    inline int
+daa_raw_write(
+    const char *path,
+    const daa_desc *desc,
+    int *err_code)
+{
+    return file_write(path, NULL, 0, desc, err_code);
+}
+
+/*
+ * daa_head:
+ *     the header of a file written by daa_save(), filled in by
+ *     das_load().
+ */
+
+struct daa_head
+{
+    size_t data_size;           /* size of the basic array data object */
+    unsigned int num_dim;       /* number of array dimensions */
+    size_t dim[MAX_DIM];        /* dimensions */
+    ptrdiff_t st[MAX_DIM];      /* start subscripts */
+    daa_layout layout;          /* the layout of the saved array */
+    size_t data_bytes;          /* bytes of data in the file */
+    size_t head_len;            /* offset of the data in the file */
+    daa_u32 sum[2];             /* checksum of the data, see daa_sum() */
+};
+
+/*
+ * daa_sum:
+ *     add len bytes at p to a Fletcher style checksum of 32 bit words,
+ *     sum[0] the sum of the words and sum[1] the sum of the sums, both
+ *     modulo 2^32.  a final part word is zero filled.  the sums catch a
+ *     changed, lost or moved word, at two adds a word.  start with both
+ *     sums 0, len a multiple of 4 for all but the last part.
+ *
+ * Arguments:
+ *     const char *p
+ *        the bytes.
+ *
+ *     size_t len
+ *        number of bytes.
+ *
+ *     daa_u32 *sum
+ *        the two sums, updated.
+ */
+
+    inline void
+daa_sum(
+    const char *p,
+    size_t len,
+    daa_u32 *sum)
+{
+    daa_u32 a = sum[0];
+    daa_u32 b = sum[1];
+    daa_u32 w;
+    size_t i;
+
+
+    for ( i = 0 ; i + 4 <= len ; i += 4 )
+    {
+        memcpy(&w, p + i, 4);
+        a = (a + w) & 0xffffffffUL;
+        b = (b + a) & 0xffffffffUL;
+    }
+    if ( i < len )
+    {
+        w = 0;
+        memcpy(&w, p + i, len - i);
+        a = (a + w) & 0xffffffffUL;
+        b = (b + a) & 0xffffffffUL;
+    }
+
+    sum[0] = a;
+    sum[1] = b;
+}
+
+/*
+ * save_put:
+ *     store v in 8 bytes at p, least significant byte first.
+ */
+
+    static void
+save_put(
+    char *p,
+    size_t v)
+{
+    unsigned int i;
+
+
+    for ( i = 0 ; i < 8 ; i++ )
+    {
+        p[i] = (char) (i < sizeof(size_t) ? (v >> (8 * i)) & 0xff : 0);
+    }
+}
+
+/*
+ * save_get:
+ *     the 8 byte value at p stored by save_put(), or (size_t) -1 if it
+ *     does not fit a size_t.
+ */
+
+    static size_t
+save_get(
+    const char *p)
+{
+    size_t v = 0;
+    unsigned int i;
+
+
+    for ( i = 8 ; i-- > 0 ; )
+    {
+        if ( i >= sizeof(size_t) )
+        {
+            if ( p[i] != 0 )
+            {
+                return (size_t) -1;
+            }
+            continue;
+        }
+        v = (v << 8) | (unsigned char) p[i];
+    }
+
+    return v;
+}
+
+/*
+ * save_head:
+ *     build the daa_save() header of an array in head, the checksum sum
+ *     of its live bytes of data, and return the header length.
+ */
+
+    static size_t
+save_head(
+    char *head,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    const daa_geom *g,
+    size_t live,
+    const daa_u32 *sum)
+{
+    unsigned short one = 1;
+    size_t len;
+    unsigned int i;
+
+
+    len = (8 + 8 * (10 + 2 * (size_t) num_dim) + SAVE_ALIGN - 1) / SAVE_ALIGN * SAVE_ALIGN;
+    memset(head, 0, len);
+    memcpy(head, "\x93" "DAA\r\n\x1a\n", 8);
+    save_put(head + 8, 1);
+    save_put(head + 16, len);
+    save_put(head + 24, (*(char *) &one == 1) ? 1 : 2);
+    save_put(head + 32, data_size);
+    save_put(head + 40, num_dim);
+    save_put(head + 48, g->flags & ~DAA_ZEROED);
+    save_put(head + 56, g->align);
+    save_put(head + 64, (layout != NULL) ? layout->cap0 : 0);
+    save_put(head + 72, live);
+    for ( i = 0 ; i < 4 ; i++ )
+    {
+        head[80 + i] = (char) ((sum[0] >> (8 * i)) & 0xff);
+        head[84 + i] = (char) ((sum[1] >> (8 * i)) & 0xff);
+    }
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        save_put(head + 88 + 8 * i, dim[i]);
+        save_put(head + 88 + 8 * (num_dim + i), (size_t) st[i]);
+    }
+
+    return len;
+}
+
+/*
+ * save_fd:
+ *     daa_save() to the open file fd.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set, see daa_save().
+ */
+
+    static int
+save_fd(
+    int fd,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr)
+{
+    char head[SAVE_HEAD_MAX];
+    struct iovec iov[2];
+    daa_u32 sum[2] = {0, 0};
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+    size_t live;        /* bytes of the elements of dimension 0 */
+    size_t len;
+    size_t off = 0;
+    ssize_t n;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return -1;
+    }
+    blk_place(base_ptr, &g, &data_ptr, &ptr_ptr);
+    live = g.data_bytes / g.dp[0] * dim[0];
+    daa_sum(data_ptr, live, sum);
+    len = save_head(head, data_size, num_dim, dim, st, layout, &g, live, sum);
+
+    iov[0].iov_base = head;
+    iov[0].iov_len = len;
+    iov[1].iov_base = data_ptr;
+    iov[1].iov_len = live;
+    while ( iov[0].iov_len + iov[1].iov_len > 0 )
+    {
+        n = pwritev(fd, iov[0].iov_len > 0 ? iov : iov + 1, iov[0].iov_len > 0 ? 2 : 1,
+            (off_t) off);
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n <= 0 )
+        {
+            *err_code = ERRS_SYS;
+            return -1;
+        }
+        off += (size_t) n;
+        if ( (size_t) n >= iov[0].iov_len )
+        {
+            n -= (ssize_t) iov[0].iov_len;
+            iov[0].iov_len = 0;
+            iov[1].iov_base = (char *) iov[1].iov_base + n;
+            iov[1].iov_len -= (size_t) n;
+        }
+        else
+        {
+            iov[0].iov_base = (char *) iov[0].iov_base + n;
+            iov[0].iov_len -= (size_t) n;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * daa_save:
+ *     save an array built by daa() to a file, a header and the data area,
+ *     without the pointers and the unused capacity of a layout cap0.  the
+ *     header holds the shape, start subscripts, layout and a checksum of
+ *     the data, all 8 byte little endian values, and is padded to a
+ *     multiple of SAVE_ALIGN bytes.  the header and the data are written
+ *     with one pwritev().  the data is in the byte order of this machine,
+ *     the header records it, see das_load().
+ *
+ *     the file is:
+ *         "\x93DAA\r\n\x1a\n"     magic
+ *         version(1), header length, byte order(1 little, 2 big),
+ *         data_size, num_dim, layout flags, align, cap0, data bytes,
+ *         checksum(sum[1] << 32 | sum[0]), dim[num_dim], st[num_dim]
+ *         padding to the header length
+ *         the data area
+ *
+ * Arguments:
+ *     const char *path
+ *        the file, created or truncated.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code, char *base_ptr
+ *        the same arguments given to daa().
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set, see das().
+ *     ERRS_SYS - a system call failed, errno tells why.
+ */
+
+    inline int
+daa_save(
+    const char *path,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr)
+{
+    daa_geom g;
+    int fd;
+    int err;
+
+
+    /* check the shape before the file is truncated */
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return -1;
+    }
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( save_fd(fd, data_size, num_dim, dim, st, layout, err_code, base_ptr) < 0 )
+    {
+        err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    if ( close(fd) != 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * das_load:
+ *     read the header of a file written by daa_save() and return the
+ *     das() size of the block to load it into, the usual sequence is
+ *     das_load()/daa_alloc()/daa_load().  the layout in head is the saved
+ *     layout.
+ *
+ * Arguments:
+ *     const char *path
+ *        the file.
+ *
+ *     daa_head *head
+ *        returned header.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     the das() size, or 0 and an error code in *err_code, see das().
+ *     ERRS_FILE - the file is not a daa_save() file of this byte order.
+ *     ERRS_SYS - a system call failed, errno tells why.
+ */
+
+    inline size_t
+das_load(
+    const char *path,
+    daa_head *head,
+    int *err_code)
+{
+    char buf[SAVE_HEAD_MAX];
+    unsigned short one = 1;
+    ssize_t n;
+    size_t len = 0;
+    unsigned int i;
+    int fd;
+
+
+    fd = open(path, O_RDONLY);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return 0;
+    }
+    while ( len < sizeof(buf) )
+    {
+        n = read(fd, buf + len, sizeof(buf) - len);
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n < 0 )
+        {
+            close(fd);
+            *err_code = ERRS_SYS;
+            return 0;
+        }
+        if ( n == 0 )
+        {
+            break;
+        }
+        len += (size_t) n;
+    }
+    close(fd);
+
+    if ( len < 88 || memcmp(buf, "\x93" "DAA\r\n\x1a\n", 8) != 0 ||
+        save_get(buf + 8) != 1 ||
+        save_get(buf + 24) != (size_t) ((*(char *) &one == 1) ? 1 : 2) ||
+        (head->num_dim = (unsigned int) save_get(buf + 40)) < 1 ||
+        save_get(buf + 40) > MAX_DIM ||
+        (head->head_len = save_get(buf + 16)) < 88 + 16 * (size_t) head->num_dim ||
+        head->head_len > len )
+    {
+        *err_code = ERRS_FILE;
+        return 0;
+    }
+    head->data_size = save_get(buf + 32);
+    head->layout.flags = (unsigned int) save_get(buf + 48);
+    head->layout.align = save_get(buf + 56);
+    head->layout.cap0 = save_get(buf + 64);
+    head->data_bytes = save_get(buf + 72);
+    head->sum[0] = 0;
+    head->sum[1] = 0;
+    for ( i = 4 ; i-- > 0 ; )
+    {
+        head->sum[0] = (head->sum[0] << 8) | (unsigned char) buf[80 + i];
+        head->sum[1] = (head->sum[1] << 8) | (unsigned char) buf[84 + i];
+    }
+    for ( i = 0 ; i < head->num_dim ; i++ )
+    {
+        head->dim[i] = save_get(buf + 88 + 8 * i);
+        head->st[i] = (ptrdiff_t) save_get(buf + 88 + 8 * (head->num_dim + i));
+    }
+
+    return das(head->data_size, head->num_dim, head->dim, &head->layout, err_code);
+}
+
+/*
+ * daa_load:
+ *     read the data of a file written by daa_save() straight into the data
+ *     area of the space pointed to by base_ptr, of the das_load() size,
+ *     check the checksum and build the pointers with daa().
+ *
+ * Arguments:
+ *     const char *path
+ *        the file.
+ *
+ *     const daa_head *head
+ *        the header from das_load().
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space, aligned to the layout align of a
+ *        DAA_OFF32 or DAA_REL layout, see daa().
+ *
+ * Returns:
+ *     the array pointer, or NULL and an error code in *err_code, see
+ *     daa().
+ *     ERRS_FILE - the file is too short or the checksum is wrong.
+ *     ERRS_SYS - a system call failed, errno tells why.
+ */
+
+    inline void *
+daa_load(
+    const char *path,
+    const daa_head *head,
+    int *err_code,
+    char *base_ptr)
+{
+    daa_u32 sum[2] = {0, 0};
+    daa_geom g;
+    char *data_ptr;
+    char *ptr_ptr;
+    size_t dim[MAX_DIM];
+    ptrdiff_t st[MAX_DIM];
+    size_t len = 0;
+    ssize_t n;
+    unsigned int i;
+    int fd;
+
+
+    for ( i = 0 ; i < head->num_dim ; i++ )
+    {
+        dim[i] = head->dim[i];
+        st[i] = head->st[i];
+    }
+    if ( geom(head->data_size, head->num_dim, dim, &head->layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+    if ( head->data_bytes != g.data_bytes / g.dp[0] * dim[0] )
+    {
+        *err_code = ERRS_FILE;
+        return NULL;
+    }
+    blk_place(base_ptr, &g, &data_ptr, &ptr_ptr);
+
+    fd = open(path, O_RDONLY);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return NULL;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, (off_t) head->head_len, (off_t) head->data_bytes,
+        POSIX_FADV_SEQUENTIAL);
+#endif
+    while ( len < head->data_bytes )
+    {
+        n = pread(fd, data_ptr + len, head->data_bytes - len,
+            (off_t) (head->head_len + len));
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n <= 0 )
+        {
+            close(fd);
+            *err_code = (n < 0) ? ERRS_SYS : ERRS_FILE;
+            return NULL;
+        }
+        len += (size_t) n;
+    }
+    close(fd);
+
+    daa_sum(data_ptr, len, sum);
+    if ( sum[0] != head->sum[0] || sum[1] != head->sum[1] )
+    {
+        *err_code = ERRS_FILE;
+        return NULL;
+    }
+
+    return daa(head->data_size, head->num_dim, dim, st, &head->layout, err_code,
+        base_ptr, NULL);
+}
+
+/*
+ * slab_ent:
+ *     a resident slab of a daa_slabs cache.
+ */
+
+struct slab_ent
+{
+    size_t index;       /* the slab number, (size_t) -1 for none */
+    size_t used;        /* the tick of the last use, for LRU eviction */
+    char *map;          /* the slab mapping */
+    size_t map_size;    /* byte length of the mapping */
+    char *ptrs;         /* the pointer area of the slab */
+    void *array;        /* the slab array pointer */
+};
+
+/*
+ * daa_slabs:
+ *     an out of core array, a file of row major data read in slabs of
+ *     dimension 0, filled in by daa_slabs_open().
+ */
+
+struct daa_slabs
+{
+    int fd;                     /* the file */
+    int mode;                   /* DAA_FILE_READ, DAA_FILE_COW or DAA_FILE_WRITE */
+    size_t offset;              /* offset of the data in the file */
+    size_t data_size;           /* size of the basic array data object */
+    unsigned int num_dim;       /* number of array dimensions */
+    size_t dim[MAX_DIM];        /* dimensions */
+    ptrdiff_t st[MAX_DIM];      /* start subscripts */
+    size_t row_bytes;           /* bytes of one element of dimension 0 */
+    size_t slab_rows;           /* elements of dimension 0 in a slab */
+    unsigned int max_slabs;     /* slabs resident at most */
+    slab_ent *ent;              /* the resident slabs, max_slabs of them */
+    size_t tick;                /* use counter */
+    size_t last;                /* the slab of the last daa_slabs_get() */
+    size_t loads;               /* slabs mapped */
+    size_t hits;                /* daa_slabs_get() calls served by a resident slab */
+};
+
+/*
+ * daa_slabs_open:
+ *     open a file of row major data, at offset in the file, as an out of
+ *     core array read in slabs of slab_rows elements of dimension 0.  at
+ *     most max_slabs slabs are resident, each mapped with its own pointer
+ *     area(see daa_adopt()), the least recently used slab is unmapped to
+ *     make room for another.  daa_slabs_get() returns the array of the slab of
+ *     a subscript.  release the array with daa_slabs_close(), also after a
+ *     failure.
+ *
+ * Arguments:
+ *     const char *path
+ *        the file, such as a daa_raw_write() file, or a .npy file with
+ *        offset file.data - file.map of daa_npy_map().
+ *
+ *     size_t offset
+ *        the offset of the data in the file.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st
+ *        see daa().
+ *
+ *     size_t slab_rows
+ *        elements of dimension 0 in a slab, > 0.
+ *
+ *     unsigned int max_slabs
+ *        slabs resident at most, > 0.
+ *
+ *     int mode
+ *        DAA_FILE_READ, DAA_FILE_COW(the changes to a slab are lost when
+ *        it is unmapped) or DAA_FILE_WRITE.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_slabs *slabs
+ *        returned out of core array.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set, see das(),
+ *     ERRS_NO_MEM and ERRS_SYS.
+ *     ERRS_CAPACITY - slab_rows or max_slabs is 0.
+ *     ERRS_FILE - the file is too short for the array.
+ */
+
+    inline int
+daa_slabs_open(
+    const char *path,
+    size_t offset,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    size_t slab_rows,
+    unsigned int max_slabs,
+    int mode,
+    int *err_code,
+    daa_slabs *slabs)
+{
+    size_t sdim[MAX_DIM];
+    struct stat sb;
+    daa_geom g;
+    size_t size;
+    unsigned int i;
+
+
+    slabs->fd = -1;
+    slabs->ent = NULL;
+    slabs->max_slabs = 0;
+    if ( adopt_geom(data_size, num_dim, dim, NULL, &g, err_code) < 0 )
+    {
+        return -1;
+    }
+    if ( slab_rows == 0 || max_slabs == 0 )
+    {
+        *err_code = ERRS_CAPACITY;
+        return -1;
+    }
+
+    slabs->mode = mode;
+    slabs->offset = offset;
+    slabs->data_size = data_size;
+    slabs->num_dim = num_dim;
+    for ( i = 0 ; i < num_dim ; i++ )
+    {
+        slabs->dim[i] = dim[i];
+        slabs->st[i] = st[i];
+        sdim[i] = dim[i];
+    }
+    slabs->row_bytes = g.data_bytes / dim[0];
+    slabs->slab_rows = (slab_rows < dim[0]) ? slab_rows : dim[0];
+    slabs->tick = 0;
+    slabs->last = (size_t) -1;
+    slabs->loads = 0;
+    slabs->hits = 0;
+
+    slabs->fd = mode_open(path, mode);
+    if ( slabs->fd < 0 || fstat(slabs->fd, &sb) != 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( offset > (size_t) sb.st_size || g.data_bytes > (size_t) sb.st_size - offset )
+    {
+        *err_code = ERRS_FILE;
+        return -1;
+    }
+
+    /* every slab has a pointer area for slab_rows elements */
+    sdim[0] = slabs->slab_rows;
+    size = das_adopt(data_size, num_dim, sdim, NULL, err_code);
+    slabs->ent = (slab_ent *) calloc(max_slabs, sizeof(slab_ent));
+    if ( slabs->ent == NULL )
+    {
+        *err_code = ERRS_NO_MEM;
+        return -1;
+    }
+    slabs->max_slabs = max_slabs;
+    for ( i = 0 ; i < max_slabs ; i++ )
+    {
+        slabs->ent[i].index = (size_t) -1;
+    }
+    for ( i = 0 ; i < max_slabs ; i++ )
+    {
+        slabs->ent[i].ptrs = (char *) malloc(size);
+        if ( slabs->ent[i].ptrs == NULL )
+        {
+            *err_code = ERRS_NO_MEM;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * daa_slabs_get:
+ *     the array of the slab that holds the elements of subscript i0 of
+ *     dimension 0.  it is indexed with the subscripts of the whole array,
+ *     array[i0][i1]...[in-1], for the i0 of the slab, slab_rows elements
+ *     from st[0] + k*slab_rows.  the slab is mapped if it is not
+ *     resident, which may unmap the least recently used slab, so the
+ *     pointer of a slab is valid until max_slabs other slabs are used.
+ *     when the slabs are used in order the next slab is read ahead with
+ *     posix_fadvise(), and a read only slab that is unmapped is dropped
+ *     from the page cache, so a sweep streams the file with at most
+ *     max_slabs slabs of memory.
+ *
+ * Arguments:
+ *     daa_slabs *slabs
+ *        the out of core array.
+ *
+ *     ptrdiff_t i0
+ *        a subscript of dimension 0.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     the slab array pointer, or NULL and an error code in *err_code, see
+ *     daa_adopt().
+ *     ERRS_SUBSCRIPT - i0 is not a subscript of dimension 0.
+ *     ERRS_SYS - mmap() failed, errno tells why.
+ */
+
+    inline void *
+daa_slabs_get(
+    daa_slabs *slabs,
+    ptrdiff_t i0,
+    int *err_code)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t sdim[MAX_DIM];
+    ptrdiff_t sst[MAX_DIM];
+    slab_ent *e;
+    size_t k;           /* the slab */
+    size_t rows;        /* elements of dimension 0 in the slab */
+    size_t off;         /* file offset of the slab data */
+    size_t start;       /* off rounded down to a page */
+    size_t len;
+    unsigned int i;
+
+
+    if ( i0 < slabs->st[0] || i0 >= slabs->st[0] + (ptrdiff_t) slabs->dim[0] )
+    {
+        *err_code = ERRS_SUBSCRIPT;
+        return NULL;
+    }
+    k = (size_t) (i0 - slabs->st[0]) / slabs->slab_rows;
+
+    /* resident, else the unused or least recently used entry */
+    e = &slabs->ent[0];
+    for ( i = 0 ; i < slabs->max_slabs ; i++ )
+    {
+        if ( slabs->ent[i].index == k )
+        {
+            e = &slabs->ent[i];
+            e->used = ++slabs->tick;
+            slabs->last = k;
+            slabs->hits++;
+            return e->array;
+        }
+        if ( slabs->ent[i].index == (size_t) -1 ||
+            (e->index != (size_t) -1 && slabs->ent[i].used < e->used) )
+        {
+            e = &slabs->ent[i];
+        }
+    }
+
+    rows = slabs->dim[0] - k * slabs->slab_rows;
+    rows = (rows < slabs->slab_rows) ? rows : slabs->slab_rows;
+    off = slabs->offset + k * slabs->slab_rows * slabs->row_bytes;
+    start = off / page * page;
+    len = off - start + rows * slabs->row_bytes;
+
+    if ( e->index != (size_t) -1 )
+    {
+        munmap(e->map, e->map_size);
+#if defined(POSIX_FADV_DONTNEED)
+        if ( slabs->mode == DAA_FILE_READ )
+        {
+            posix_fadvise(slabs->fd, (off_t) (slabs->offset +
+                e->index * slabs->slab_rows * slabs->row_bytes),
+                (off_t) (slabs->slab_rows * slabs->row_bytes), POSIX_FADV_DONTNEED);
+        }
+#endif
+        e->index = (size_t) -1;
+    }
+
+    e->map = mode_map(slabs->fd, start, len, slabs->mode);
+    if ( e->map == NULL )
+    {
+        *err_code = ERRS_SYS;
+        return NULL;
+    }
+    e->map_size = len;
+    for ( i = 0 ; i < slabs->num_dim ; i++ )
+    {
+        sdim[i] = slabs->dim[i];
+        sst[i] = slabs->st[i];
+    }
+    sdim[0] = rows;
+    sst[0] = slabs->st[0] + (ptrdiff_t) (k * slabs->slab_rows);
+    e->array = daa_adopt(slabs->data_size, slabs->num_dim, sdim, sst, NULL, err_code,
+        e->map + (off - start), e->ptrs);
+    if ( e->array == NULL )
+    {
+        munmap(e->map, e->map_size);
+        return NULL;
+    }
+    e->index = k;
+    e->used = ++slabs->tick;
+    slabs->loads++;
+
+    /* a sequential sweep, read the next slab ahead */
+#if defined(POSIX_FADV_WILLNEED)
+    if ( k == slabs->last + 1 && (k + 1) * slabs->slab_rows < slabs->dim[0] )
+    {
+        posix_fadvise(slabs->fd, (off_t) (off + rows * slabs->row_bytes),
+            (off_t) (slabs->slab_rows * slabs->row_bytes), POSIX_FADV_WILLNEED);
+    }
+#endif
+    slabs->last = k;
+
+    return e->array;
+}
+
+/*
+ * daa_slabs_close:
+ *     unmap the resident slabs of an out of core array, free the pointer
+ *     areas and close the file.
+ *
+ * Arguments:
+ *     daa_slabs *slabs
+ *        the out of core array.
+ */
+
+    inline void
+daa_slabs_close(
+    daa_slabs *slabs)
+{
+    unsigned int i;
+
+
+    for ( i = 0 ; i < slabs->max_slabs ; i++ )
+    {
+        if ( slabs->ent[i].index != (size_t) -1 )
+        {
+            munmap(slabs->ent[i].map, slabs->ent[i].map_size);
+        }
+        free(slabs->ent[i].ptrs);
+    }
+    free(slabs->ent);
+    if ( slabs->fd >= 0 )
+    {
+        close(slabs->fd);
+    }
+    slabs->fd = -1;
+    slabs->ent = NULL;
+    slabs->max_slabs = 0;
+}
+
+/*
+ * daa_dirty:
+ *     the changed parts of an array since its last checkpoint, a bit for
+ *     every unit of the data area, filled in by daa_dirty_init() and set
+ *     by daa_dirty_set(), and what the tracker knows of the checkpoint
+ *     files.
+ */
+
+struct daa_dirty
+{
+    char *data;                 /* the data area of the array */
+    size_t live;                /* bytes of the elements of dimension 0 */
+    size_t unit;                /* bytes of data a bit stands for */
+    size_t units;               /* bits */
+    unsigned char *bits;        /* the units changed since the last checkpoint */
+    unsigned char *prev;        /* the units the last checkpoint changed */
+    char *path;                 /* the checkpoint file of the tracker */
+    int known;                  /* whole checkpoints in path.0 and path.1, 0 to 2 */
+    size_t written;             /* bytes of data the last checkpoint writes */
+};
+
+/*
+ * daa_dirty_init:
+ *     start tracking the changes to an array built by daa(), in units of
+ *     unit_rows innermost rows.  the first two checkpoints write all the
+ *     data.  release the tracker with daa_dirty_free(), also after a
+ *     failure.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim,
+ *     const daa_layout *layout, int *err_code, char *base_ptr
+ *        the same arguments given to daa().
+ *
+ *     size_t unit_rows
+ *        innermost rows(dim[num_dim - 1] elements and the row padding) a
+ *        bit stands for, 0 for as many as fill a page.
+ *
+ *     daa_dirty *dirty
+ *        returned tracker.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set, see das() and
+ *     ERRS_NO_MEM.
+ */
+
+    inline int
+daa_dirty_init(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    size_t unit_rows,
+    daa_dirty *dirty)
+{
+    daa_geom g;
+    char *ptr_ptr;
+
+
+    dirty->bits = NULL;
+    dirty->prev = NULL;
+    dirty->path = NULL;
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return -1;
+    }
+    blk_place(base_ptr, &g, &dirty->data, &ptr_ptr);
+    if ( unit_rows == 0 )
+    {
+        unit_rows = (size_t) sysconf(_SC_PAGESIZE) / g.pitch;
+        unit_rows = (unit_rows == 0) ? 1 : unit_rows;
+    }
+
+    dirty->live = g.data_bytes / g.dp[0] * dim[0];
+    dirty->unit = (unit_rows < dirty->live / g.pitch) ? unit_rows * g.pitch : dirty->live;
+    dirty->units = (dirty->live + dirty->unit - 1) / dirty->unit;
+    dirty->known = 0;
+    dirty->written = 0;
+    dirty->bits = (unsigned char *) calloc((dirty->units + 7) / 8, 1);
+    dirty->prev = (unsigned char *) calloc((dirty->units + 7) / 8, 1);
+    if ( dirty->bits == NULL || dirty->prev == NULL )
+    {
+        *err_code = ERRS_NO_MEM;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * dirty_or:
+ *     set the bits of mask in the tracker byte at p, atomically where the
+ *     compiler has the builtins, so threads marking units that share a
+ *     byte keep each other's bits.
+ */
+
+    static void
+dirty_or(
+    unsigned char *p,
+    unsigned char mask)
+{
+#if defined(__GNUC__)
+    __atomic_fetch_or(p, mask, __ATOMIC_RELAXED);
+#else
+    *p |= mask;
+#endif
+}
+
+/*
+ * dirty_get:
+ *     the tracker byte at p, read while threads may set bits in it.
+ */
+
+    static unsigned char
+dirty_get(
+    const unsigned char *p)
+{
+#if defined(__GNUC__)
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+#else
+    return *p;
+#endif
+}
+
+/*
+ * dirty_next:
+ *     after a checkpoint forks, move its changes to prev and clear them
+ *     for the next checkpoint, a byte at a time while the writers go on,
+ *     so every mark ends up in one or the other.
+ */
+
+    static void
+dirty_next(
+    daa_dirty *dirty)
+{
+    size_t k;
+
+
+    for ( k = 0 ; k < (dirty->units + 7) / 8 ; k++ )
+    {
+#if defined(__GNUC__)
+        dirty->prev[k] = __atomic_exchange_n(&dirty->bits[k], 0, __ATOMIC_RELAXED);
+#else
+        dirty->prev[k] = dirty->bits[k];
+        dirty->bits[k] = 0;
+#endif
+    }
+}
+
+/*
+ * daa_dirty_set:
+ *     the write barrier, mark the len bytes at p in the data area as
+ *     changed.  call it for every write to the array between
+ *     checkpoints, daa_dirty_set(&dirty, &a[i][j], sizeof(a[i][j])) for
+ *     one element.  bytes outside the data area are ignored.  with gcc
+ *     or clang threads may mark at once, and while daa_checkpoint() runs.
+ *
+ * Arguments:
+ *     daa_dirty *dirty
+ *        the tracker.
+ *
+ *     const void *p
+ *        the changed bytes.
+ *
+ *     size_t len
+ *        number of bytes.
+ */
+
+    inline void
+daa_dirty_set(
+    daa_dirty *dirty,
+    const void *p,
+    size_t len)
+{
+    size_t off = (size_t) ((const char *) p - dirty->data);
+    size_t k;
+
+
+    if ( len == 0 || off >= dirty->live )
+    {
+        return;
+    }
+    len = (len < dirty->live - off) ? len : dirty->live - off;
+    for ( k = off / dirty->unit ; k <= (off + len - 1) / dirty->unit ; k++ )
+    {
+        dirty_or(&dirty->bits[k / 8], (unsigned char) (1 << (k % 8)));
+    }
+}
+
+/*
+ * daa_dirty_free:
+ *     release a tracker.
+ *
+ * Arguments:
+ *     daa_dirty *dirty
+ *        the tracker.
+ */
+
+    inline void
+daa_dirty_free(
+    daa_dirty *dirty)
+{
+    free(dirty->bits);
+    free(dirty->prev);
+    free(dirty->path);
+    dirty->bits = NULL;
+    dirty->prev = NULL;
+    dirty->path = NULL;
+    dirty->units = 0;
+}
+
+/*
+ * pwrite_all:
+ *     write len bytes at p to fd at offset off, retrying short writes.
+ *
+ * Returns:
+ *     0 on success, -1 on failure, errno tells why.
+ */
+
+    static int
+pwrite_all(
+    int fd,
+    const char *p,
+    size_t len,
+    size_t off)
+{
+    ssize_t n;
+
+
+    while ( len > 0 )
+    {
+        n = pwrite(fd, p, len, (off_t) off);
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n <= 0 )
+        {
+            return -1;
+        }
+        p += n;
+        off += (size_t) n;
+        len -= (size_t) n;
+    }
+
+    return 0;
+}
+
+/*
+ * ckpt_names:
+ *     the names of a checkpoint to path, in one allocation at file.
+ */
+
+struct ckpt_names
+{
+    char *file;         /* path.0 or path.1, the file the checkpoint writes */
+    char *name;         /* the last part of file, what the link holds */
+    char *link;         /* path.lnk, the new link renamed over path */
+    char *dir;          /* the directory of path, synced after the rename */
+};
+
+/*
+ * ckpt_name:
+ *     fill in the names of a checkpoint to path.  it writes the one of
+ *     path.0 and path.1 that path does not link to, so path keeps the last
+ *     checkpoint while the new one is written.
+ *
+ * Returns:
+ *     0 on success, -1 if out of memory.
+ */
+
+    static int
+ckpt_name(
+    const char *path,
+    ckpt_names *names)
+{
+    const char *base = strrchr(path, '/');
+    size_t n = strlen(path);
+    ssize_t r;
+
+
+    base = (base == NULL) ? path : base + 1;
+    names->file = (char *) malloc(3 * n + 11);
+    if ( names->file == NULL )
+    {
+        return -1;
+    }
+    names->name = names->file + (base - path);
+    names->link = names->file + n + 3;
+    names->dir = names->link + n + 5;
+    strcpy(names->file, path);
+    strcat(names->file, ".0");
+    strcpy(names->link, path);
+    strcat(names->link, ".lnk");
+
+    /* the link is read into dir, whose n + 3 bytes hold a name of path.0 */
+    r = readlink(path, names->dir, n + 2);
+    names->dir[(r < 0) ? 0 : r] = '\0';
+    if ( strcmp(names->dir, names->name) == 0 )
+    {
+        names->file[n + 1] = '1';
+    }
+
+    if ( base == path )
+    {
+        strcpy(names->dir, ".");
+    }
+    else
+    {
+        memcpy(names->dir, path, (size_t) (base - path));
+        names->dir[base - path] = '\0';
+    }
+
+    return 0;
+}
+
+/*
+ * ckpt_link:
+ *     in the checkpoint process, point path to the file written by a new
+ *     link renamed over it, and sync the directory so the rename is kept.
+ *
+ * Returns:
+ *     0 on success, -1 on failure, errno tells why.
+ */
+
+    static int
+ckpt_link(
+    const char *path,
+    const ckpt_names *names)
+{
+    int fd;
+
+
+    unlink(names->link);
+    if ( symlink(names->name, names->link) != 0 )
+    {
+        return -1;
+    }
+    if ( rename(names->link, path) != 0 )
+    {
+        unlink(names->link);
+        return -1;
+    }
+    fd = open(names->dir, O_RDONLY);
+    if ( fd < 0 )
+    {
+        return -1;
+    }
+    if ( fsync(fd) != 0 )
+    {
+        close(fd);
+        return -1;
+    }
+
+    return close(fd);
+}
+
+/*
+ * ckpt_same:
+ *     true if path is a daa_save() file with the header head of len
+ *     bytes, but for the checksum, and all of its data.
+ */
+
+    static int
+ckpt_same(
+    const char *path,
+    const char *head,
+    size_t len,
+    size_t live)
+{
+    char buf[SAVE_HEAD_MAX];
+    struct stat sb;
+    size_t got = 0;
+    ssize_t n;
+    int fd;
+
+
+    fd = open(path, O_RDONLY);
+    if ( fd < 0 )
+    {
+        return 0;
+    }
+    while ( got < len )
+    {
+        n = pread(fd, buf + got, len - got, (off_t) got);
+        if ( n < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( n <= 0 )
+        {
+            break;
+        }
+        got += (size_t) n;
+    }
+    if ( got < len || fstat(fd, &sb) != 0 || (size_t) sb.st_size != len + live )
+    {
+        close(fd);
+        return 0;
+    }
+    close(fd);
+
+    return memcmp(buf, head, 80) == 0 && memcmp(buf + 88, head + 88, len - 88) == 0;
+}
+
+/*
+ * ckpt_full:
+ *     in the checkpoint process, daa_save() an array to the file of names,
+ *     sync it and link path to it, so path holds the last checkpoint until
+ *     the new one is whole.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set.
+ */
+
+    static int
+ckpt_full(
+    const char *path,
+    const ckpt_names *names,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr)
+{
+    int fd;
+
+
+    fd = open(names->file, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( save_fd(fd, data_size, num_dim, dim, st, layout, err_code, base_ptr) < 0 )
+    {
+        close(fd);
+        unlink(names->file);
+        return -1;
+    }
+    if ( fsync(fd) != 0 || close(fd) != 0 )
+    {
+        unlink(names->file);
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( ckpt_link(path, names) < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * ckpt_write:
+ *     in the checkpoint process, bring the file of names, which holds the
+ *     checkpoint before the last, up to date.  the units changed since
+ *     then, those of the last checkpoint and the new ones, are written
+ *     each run of adjacent units with one pwrite(), then the header with
+ *     the checksum of all the data, the file is synced and path linked to
+ *     it.  path holds the last checkpoint until then, a checkpoint cut
+ *     short spoils only the file written, and the next checkpoint rewrites
+ *     it whole, see daa_checkpoint_wait().
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set.
+ */
+
+    static int
+ckpt_write(
+    const char *path,
+    const ckpt_names *names,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    const daa_geom *g,
+    const daa_dirty *dirty)
+{
+    char head[SAVE_HEAD_MAX];
+    daa_u32 sum[2] = {0, 0};
+    size_t len;
+    size_t end;         /* end of a run of changed units */
+    size_t k;
+    size_t j;
+    int fd;
+
+
+    daa_sum(dirty->data, dirty->live, sum);
+    len = save_head(head, data_size, num_dim, dim, st, layout, g, dirty->live, sum);
+
+    fd = open(names->file, O_WRONLY);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    for ( k = 0 ; k < dirty->units ; k = j )
+    {
+        j = k + 1;
+        if ( ((dirty->bits[k / 8] | dirty->prev[k / 8]) & (1 << (k % 8))) == 0 )
+        {
+            continue;
+        }
+        while ( j < dirty->units &&
+            ((dirty->bits[j / 8] | dirty->prev[j / 8]) & (1 << (j % 8))) )
+        {
+            j++;
+        }
+        end = (j * dirty->unit < dirty->live) ? j * dirty->unit : dirty->live;
+        if ( pwrite_all(fd, dirty->data + k * dirty->unit, end - k * dirty->unit,
+            len + k * dirty->unit) < 0 )
+        {
+            close(fd);
+            *err_code = ERRS_SYS;
+            return -1;
+        }
+    }
+    if ( pwrite_all(fd, head, len, 0) < 0 || fdatasync(fd) != 0 )
+    {
+        close(fd);
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( close(fd) != 0 || ckpt_link(path, names) < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * daa_checkpoint:
+ *     start a checkpoint of an array built by daa() to the daa_save()
+ *     file path.  the process is forked, the child has a copy on write
+ *     snapshot of the array as it is at the call, writes it and exits,
+ *     and the caller goes on changing the array at once, the pages it
+ *     writes are copied by the system for the child.
+ *
+ *     the checkpoints alternate between the files path.0 and path.1, and
+ *     path is a symbolic link to the last whole one.  the child writes
+ *     the file path does not link to, syncs it and only then links path
+ *     to it by a rename(), so a checkpoint cut short by a crash, a kill or
+ *     a full disk leaves path holding the last one.  with a tracker the
+ *     other file holds the checkpoint before the last, and the child
+ *     writes into it only the units changed since then, those of the last
+ *     checkpoint and the new ones.  the first two checkpoints of a tracker
+ *     or of a tracker to another path, one after a failed checkpoint, one
+ *     of an array of another size, or one to a file whose header is not
+ *     that of the array saves all the data.  wait for every checkpoint
+ *     with daa_checkpoint_wait() before the next one of the tracker.
+ *
+ *     the snapshot is only frozen for private memory, daa_alloc(),
+ *     daa_map_huge() and the like, not for a block in shared memory
+ *     (daa_shm_create(), DAA_FILE_WRITE), whose pages the child shares.
+ *     the child makes only system calls, so the caller may have threads,
+ *     and they may go on writing the array and calling daa_dirty_set()
+ *     during the call.  a unit marked before the fork is written by this
+ *     checkpoint and again by the next, one marked after it by the next.
+ *
+ * Arguments:
+ *     const char *path
+ *        the checkpoint file, a symbolic link daa_load() reads through.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code, char *base_ptr
+ *        the same arguments given to daa().
+ *
+ *     daa_dirty *dirty
+ *        the tracker of the array, or NULL to save all the data.
+ *        dirty->written is set to the bytes of data the child writes.
+ *
+ * Returns:
+ *     the process id of the child, or -1 with *err_code set, see das()
+ *     and ERRS_NO_MEM.
+ *     ERRS_SYS - fork() failed, errno tells why.
+ */
+
+    inline pid_t
+daa_checkpoint(
+    const char *path,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *base_ptr,
+    daa_dirty *dirty)
+{
+    char head[SAVE_HEAD_MAX];
+    daa_u32 sum[2] = {0, 0};
+    daa_geom g;
+    ckpt_names names;
+    size_t live;
+    size_t len;
+    int full;
+    size_t k;
+    pid_t pid;
+
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return -1;
+    }
+    live = g.data_bytes / g.dp[0] * dim[0];
+    if ( ckpt_name(path, &names) < 0 )
+    {
+        *err_code = ERRS_NO_MEM;
+        return -1;
+    }
+
+    /* a tracker knows the files of one path */
+    if ( dirty != NULL && (dirty->path == NULL || strcmp(dirty->path, path) != 0) )
+    {
+        free(dirty->path);
+        dirty->path = (char *) malloc(strlen(path) + 1);
+        if ( dirty->path == NULL )
+        {
+            free(names.file);
+            *err_code = ERRS_NO_MEM;
+            return -1;
+        }
+        strcpy(dirty->path, path);
+        dirty->known = 0;
+    }
+
+    full = (dirty == NULL || dirty->known < 2 || dirty->live != live);
+    if ( !full )
+    {
+        len = save_head(head, data_size, num_dim, dim, st, layout, &g, live, sum);
+        full = !ckpt_same(names.file, head, len, live);
+    }
+    if ( dirty != NULL )
+    {
+        dirty->written = full ? live : 0;
+        for ( k = 0 ; !full && k < dirty->units ; k++ )
+        {
+            if ( (dirty_get(&dirty->bits[k / 8]) | dirty->prev[k / 8]) & (1 << (k % 8)) )
+            {
+                dirty->written += (k + 1 < dirty->units) ? dirty->unit :
+                    dirty->live - k * dirty->unit;
+            }
+        }
+    }
+
+    pid = fork();
+    if ( pid < 0 )
+    {
+        free(names.file);
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+    if ( pid == 0 )
+    {
+        if ( (full && ckpt_full(path, &names, data_size, num_dim, dim, st, layout,
+            err_code, base_ptr) < 0) || (!full && ckpt_write(path, &names, data_size,
+            num_dim, dim, st, layout, err_code, &g, dirty) < 0) )
+        {
+            _exit(1 + *err_code);
+        }
+        _exit(0);
+    }
+    free(names.file);
+
+    if ( dirty != NULL )
+    {
+        dirty_next(dirty);
+        dirty->known = (dirty->known < 2) ? dirty->known + 1 : 2;
+    }
+
+    return pid;
+}
+
+/*
+ * daa_checkpoint_wait:
+ *     wait for a checkpoint started by daa_checkpoint() to finish.  when
+ *     it failed the file it wrote is spoiled, so its changes are marked
+ *     again in the tracker and the next checkpoint saves all the data.
+ *
+ * Arguments:
+ *     pid_t pid
+ *        the process id daa_checkpoint() returned.
+ *
+ *     daa_dirty *dirty
+ *        the tracker given to daa_checkpoint(), or NULL.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ * Returns:
+ *     0 when the checkpoint is written, -1 on failure with *err_code
+ *     set to the error of the checkpoint, see daa_save().
+ *     ERRS_SYS - the checkpoint or waitpid() failed, errno tells why
+ *     for waitpid() only.
+ */
+
+    inline int
+daa_checkpoint_wait(
+    pid_t pid,
+    daa_dirty *dirty,
+    int *err_code)
+{
+    int status = 0;
+    pid_t r;
+    size_t k;
+
+
+    do
+    {
+        r = waitpid(pid, &status, 0);
+    } while ( r < 0 && errno == EINTR );
+    if ( r < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 )
+    {
+        *err_code = ERRS_SYS;
+        if ( r >= 0 && WIFEXITED(status) && (size_t) WEXITSTATUS(status) - 1 <
+            sizeof(daa_errs) / sizeof(daa_errs[0]) )
+        {
+            *err_code = WEXITSTATUS(status) - 1;
+        }
+        if ( dirty != NULL )
+        {
+            for ( k = 0 ; k < (dirty->units + 7) / 8 ; k++ )
+            {
+                dirty_or(&dirty->bits[k], dirty->prev[k]);
+            }
+            dirty->known = (dirty->known == 2) ? 1 : 0;
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+} // daa namespace
+
+#endif  // DAA_FILE_HPP
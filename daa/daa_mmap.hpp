@@ -0,0 +1,677 @@
+//  daa_mmap.hpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#ifndef DAA_MMAP_HPP
+#define DAA_MMAP_HPP
+
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "daa.hpp"
+
+namespace Daa
+{
+
+const size_t HUGE_PAGE = 2*1024*1024; /* huge page size daa_map_huge() maps in */
+
+/*
+ *==================================================================================================
+ * File: daa_mmap.hpp
+ *
+ * Description:
+ *     mmap() based space for das()/daa() blocks.  instead of the caller
+ *     allocating the space between das() and daa(), these routines map it,
+ *     build the array in it with daa() and return the mapping in a daa_map
+ *     that is later given to daa_unmap().
+ *
+ *     daa_map_huge() maps the block in huge pages.  it tries explicit huge
+ *     pages(MAP_HUGETLB) first, then normal pages advised for transparent
+ *     huge pages(MADV_HUGEPAGE), then plain normal pages, and reports the
+ *     kind it obtained in the stats.  the data and the pointer arrays are
+ *     one block, so the pointers share the huge pages of the data and a
+ *     pointer walk costs no more TLB entries than the data access.
+ *
+ *     daa_shm_create() builds a position independent(DAA_OFF32 or DAA_REL)
+ *     block in a new POSIX shared memory object, and daa_shm_attach() maps
+ *     the object, in any process and at any address, and attaches a view
+ *     to it(see daa_attach()).  the processes share one copy of the array.
+ *     remove the object with shm_unlink() when it is no longer needed.
+ *     older C libraries need -lrt for shm_open().
+ *
+ *     daa_map_resize() grows or shrinks dimension 0 of a mapped array with
+ *     a layout cap0, in place within the capacity, else by doubling the
+ *     capacity and enlarging the mapping with mremap().
+ *
+ *     fresh mappings are zero filled, so daa_map_huge() and
+ *     daa_shm_create() build with DAA_ZEROED, and a zero init writes only
+ *     the pointer area, the data pages are mapped in on first use.
+ *
+ *     requires a POSIX system.
+ *
+ * Examples:
+ *     see daa_test.cpp
+ *
+ *==================================================================================================
+ */
+
+/*
+ * daa_map:
+ *     a mapped daa() block, filled in by the daa_map_*() routines.
+ */
+
+struct daa_map
+{
+    char *base;        /* start of the block, the daa() base_ptr */
+    char *map;         /* start of the mapping */
+    size_t map_size;   /* byte length of the mapping */
+    daa_stats stats;   /* das() stats and the kind of page mapped */
+};
+
+/*
+ * map_anon:
+ *     map len bytes of anonymous private memory.
+ *
+ * Arguments:
+ *     size_t len
+ *        byte length of the mapping.
+ *
+ *     int flags
+ *        extra mmap() flags.
+ *
+ * Returns:
+ *     start of the mapping, or NULL.
+ */
+
+    static char *
+map_anon(
+    size_t len,
+    int flags)
+{
+    void *p;
+
+
+    p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags,
+        -1, 0);
+
+    return (p == MAP_FAILED) ? NULL : (char *) p;
+}
+
+/*
+ * zeroed:
+ *     the layout for a block on fresh, zero filled pages, a copy of layout
+ *     with DAA_ZEROED set.
+ */
+
+    static const daa_layout *
+zeroed(
+    const daa_layout *layout,
+    daa_layout *fresh)
+{
+    if ( layout != NULL )
+    {
+        *fresh = *layout;
+    }
+    else
+    {
+        fresh->flags = 0;
+        fresh->align = 0;
+        fresh->cap0 = 0;
+    }
+    fresh->flags |= DAA_ZEROED;
+
+    return fresh;
+}
+
+/*
+ * daa_map_huge:
+ *     das()/mmap()/daa() in huge pages where possible.  the mapping is a
+ *     multiple of HUGE_PAGE bytes long and the block starts on a HUGE_PAGE
+ *     boundary.  map->stats.page_kind is DAA_PAGE_HUGETLB, DAA_PAGE_THP or
+ *     DAA_PAGE_NORMAL.  release the block with daa_unmap(), also after a
+ *     failure.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        see daa().
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ *     daa_map *map
+ *        returned mapping.
+ *
+ * Returns:
+ *     the daa() array pointer, or NULL and an error code in *err_code, see
+ *     das() and ERRS_NO_MEM.
+ */
+
+    inline void *
+daa_map_huge(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *init_ptr,
+    daa_map *map)
+{
+    daa_layout fresh;   /* the layout, on zero filled fresh pages */
+    size_t size;
+    size_t len;   /* size rounded up to whole huge pages */
+    void *array;
+
+
+    map->base = NULL;
+    map->map = NULL;
+    map->map_size = 0;
+
+    size = das(data_size, num_dim, dim, layout, &map->stats, err_code);
+    if ( size == 0 )
+    {
+        return NULL;
+    }
+    if ( size > ((size_t) -1) - 2 * HUGE_PAGE )
+    {
+        *err_code = ERRS_SIZE_OVERFLOW;
+        return NULL;
+    }
+    len = (size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+
+#if defined(MAP_HUGETLB)
+    map->map = map_anon(len, MAP_HUGETLB);
+    map->map_size = len;
+    map->base = map->map;
+    map->stats.page_kind = DAA_PAGE_HUGETLB;
+#endif
+
+    if ( map->map == NULL )
+    {
+        /* one extra huge page to align the block to a huge page boundary */
+        map->map = map_anon(len + HUGE_PAGE, 0);
+        if ( map->map == NULL )
+        {
+            *err_code = ERRS_NO_MEM;
+            return NULL;
+        }
+        map->map_size = len + HUGE_PAGE;
+        map->base = map->map + (HUGE_PAGE - (size_t) map->map % HUGE_PAGE) % HUGE_PAGE;
+        map->stats.page_kind = DAA_PAGE_NORMAL;
+#if defined(MADV_HUGEPAGE)
+        if ( madvise(map->base, len, MADV_HUGEPAGE) == 0 )
+        {
+            map->stats.page_kind = DAA_PAGE_THP;
+        }
+#endif
+    }
+
+    array = daa(data_size, num_dim, dim, st, zeroed(layout, &fresh), err_code,
+        map->base, init_ptr);
+    if ( array == NULL )
+    {
+        munmap(map->map, map->map_size);
+        map->map = NULL;
+    }
+
+    return array;
+}
+
+/*
+ * daa_unmap:
+ *     release a block mapped by a daa_map_*() routine.  the daa_map is
+ *     cleared, a cleared daa_map is ignored.
+ *
+ * Arguments:
+ *     daa_map *map
+ *        the mapping.
+ */
+
+    inline void
+daa_unmap(
+    daa_map *map)
+{
+    if ( map->map != NULL )
+    {
+        munmap(map->map, map->map_size);
+    }
+    map->base = NULL;
+    map->map = NULL;
+    map->map_size = 0;
+}
+
+/*
+ * shm_map:
+ *     open the POSIX shared memory object name, size it to size bytes if
+ *     create is set, and map it shared.
+ *
+ * Arguments:
+ *     const char *name
+ *        shared memory object name, "/name".
+ *
+ *     size_t size
+ *        byte length to map, at most the object size.
+ *
+ *     int create
+ *        non-zero to create the object, which must not exist.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     daa_map *map
+ *        returned mapping.
+ *
+ * Returns:
+ *     0 on success, -1 on failure with *err_code set to ERRS_SYS, errno
+ *     tells why.
+ */
+
+    static int
+shm_map(
+    const char *name,
+    size_t size,
+    int create,
+    int *err_code,
+    daa_map *map)
+{
+    int fd;
+    struct stat sb;
+    void *p;
+
+
+    fd = shm_open(name, create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+    if ( fd < 0 )
+    {
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    if ( (create && ftruncate(fd, (off_t) size) != 0) ||
+        (!create && (fstat(fd, &sb) != 0 || (size_t) sb.st_size < size)) )
+    {
+        close(fd);
+        if ( create )
+        {
+            shm_unlink(name);
+        }
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( p == MAP_FAILED )
+    {
+        if ( create )
+        {
+            shm_unlink(name);
+        }
+        *err_code = ERRS_SYS;
+        return -1;
+    }
+
+    map->map = (char *) p;
+    map->map_size = size;
+    map->base = map->map;
+    map->stats.page_kind = DAA_PAGE_NORMAL;
+
+    return 0;
+}
+
+/*
+ * daa_shm_create:
+ *     das()/shm_open()/mmap()/daa().  create the POSIX shared memory object
+ *     name and build a position independent array in it.  the layout must
+ *     be DAA_OFF32 or DAA_REL.  release the mapping with daa_unmap(), the
+ *     object stays until shm_unlink().
+ *
+ * Arguments:
+ *     const char *name
+ *        shared memory object name, "/name".  it must not exist.
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        see daa().
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ *     daa_map *map
+ *        returned mapping.
+ *
+ * Returns:
+ *     the daa() array pointer, valid in this mapping only, or NULL and an
+ *     error code in *err_code, see das(), ERRS_NOT_REL and ERRS_SYS.
+ */
+
+    inline void *
+daa_shm_create(
+    const char *name,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    char *init_ptr,
+    daa_map *map)
+{
+    daa_layout fresh;   /* the layout, on zero filled fresh pages */
+    size_t size;
+    void *array;
+
+
+    map->base = NULL;
+    map->map = NULL;
+    map->map_size = 0;
+
+    size = das(data_size, num_dim, dim, layout, &map->stats, err_code);
+    if ( size == 0 )
+    {
+        return NULL;
+    }
+    if ( layout == NULL || (layout->flags & (DAA_OFF32 | DAA_REL)) == 0 ||
+        (layout->flags & DAA_NO_PTRS) )
+    {
+        *err_code = ERRS_NOT_REL;
+        return NULL;
+    }
+
+    if ( shm_map(name, size, 1, err_code, map) < 0 )
+    {
+        return NULL;
+    }
+
+    array = daa(data_size, num_dim, dim, st, zeroed(layout, &fresh), err_code,
+        map->base, init_ptr);
+    if ( array == NULL )
+    {
+        daa_unmap(map);
+        shm_unlink(name);
+    }
+
+    return array;
+}
+
+/*
+ * daa_shm_attach:
+ *     map the POSIX shared memory object name holding an array built by
+ *     daa_shm_create() with the same shape and layout, and attach a view
+ *     to it.  release the mapping with daa_unmap().
+ *
+ * Arguments:
+ *     const char *name
+ *        shared memory object name, "/name".
+ *
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     const daa_layout *layout, int *err_code
+ *        the same arguments given to daa_shm_create().
+ *
+ *     daa_map *map
+ *        returned mapping.
+ *
+ *     daa_view *view
+ *        returned view.
+ *
+ * Returns:
+ *     view, or NULL and an error code in *err_code, see daa_attach() and
+ *     ERRS_SYS.
+ */
+
+    inline daa_view *
+daa_shm_attach(
+    const char *name,
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    const daa_layout *layout,
+    int *err_code,
+    daa_map *map,
+    daa_view *view)
+{
+    size_t size;
+
+
+    map->base = NULL;
+    map->map = NULL;
+    map->map_size = 0;
+
+    size = das(data_size, num_dim, dim, layout, &map->stats, err_code);
+    if ( size == 0 || shm_map(name, size, 0, err_code, map) < 0 )
+    {
+        return NULL;
+    }
+
+    if ( daa_attach(data_size, num_dim, dim, st, layout, err_code, map->base,
+        view) == NULL )
+    {
+        daa_unmap(map);
+        return NULL;
+    }
+
+    return view;
+}
+
+/*
+ * daa_map_resize:
+ *     resize dimension 0 of an array mapped by daa_map_huge() with a
+ *     layout, keeping the values of the existing elements.  within the
+ *     layout cap0 this is daa_grow().  beyond it the capacity is doubled
+ *     (or set to new_dim0 if that is larger), the mapping is enlarged with
+ *     mremap(), which may move it without copying, and the pointers are
+ *     rebuilt for the new capacity.  the data is never copied element by
+ *     element, and because the capacity doubles the amortized cost of an
+ *     append is proportional to the new elements.  without mremap(), or
+ *     for a DAA_OFF32 or DAA_REL layout aligned to more than a page, which
+ *     mremap() would not keep, the data is copied to a new mapping aligned
+ *     to a huge page with one memcpy().
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     int *err_code
+ *        the same arguments given to daa_map_huge(), dim[0] the current
+ *        dimension.  on success dim[0] is set to new_dim0.
+ *
+ *     daa_layout *layout
+ *        the layout given to daa_map_huge().  a larger cap0 is set in it
+ *        when the capacity grows, and a cap0 of 0 is set to dim[0] on a
+ *        shrink.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter for the new elements.
+ *
+ *     size_t new_dim0
+ *        the new dimension 0, > 0.
+ *
+ *     daa_map *map
+ *        the mapping, updated.
+ *
+ * Returns:
+ *     the daa() array pointer, which changes if the mapping moves, or NULL
+ *     and an error code in *err_code, see daa_grow(), ERRS_NO_MEM and
+ *     ERRS_SYS.  on failure the array and the mapping are unchanged.
+ */
+
+    inline void *
+daa_map_resize(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    daa_layout *layout,
+    int *err_code,
+    char *init_ptr,
+    size_t new_dim0,
+    daa_map *map)
+{
+    daa_layout grown;   /* the layout with the new capacity */
+    daa_geom g;         /* the geometry with the old capacity */
+    daa_geom h;         /* the geometry with the new capacity */
+    daa_stats stats;
+    char *data_ptr;
+    char *ptr_ptr;
+    char *new_map;
+    char *old_map;      /* the old mapping, kept while the block is copied */
+    char *new_base;
+    char *live;         /* the end of the live rows in the new block */
+    char *end;          /* the end of the old block in the new mapping */
+    size_t base_off;    /* offset of the block in the mapping */
+    size_t new_off;     /* offset of the block in the new mapping */
+    size_t data_off;    /* offset of the data area in the block */
+    size_t new_len;
+    size_t cap;
+    int page_kind;
+
+
+    if ( new_dim0 == 0 )
+    {
+        *err_code = ERRS_CAPACITY;
+        return NULL;
+    }
+    /* a cap0 below dim[0] is dim[0], the same geometry, so a shrink is in place */
+    if ( (layout->cap0 > dim[0] ? layout->cap0 : dim[0]) >= new_dim0 )
+    {
+        if ( layout->cap0 < dim[0] )
+        {
+            layout->cap0 = dim[0];
+        }
+        return daa_grow(data_size, num_dim, dim, st, layout, err_code, map->base,
+            new_dim0, init_ptr);
+    }
+
+    if ( geom(data_size, num_dim, dim, layout, &g, err_code) < 0 )
+    {
+        return NULL;
+    }
+    blk_place(map->base, &g, &data_ptr, &ptr_ptr);
+    data_off = (size_t) (data_ptr - map->base);
+    base_off = (size_t) (map->base - map->map);
+
+    /* double the capacity */
+    cap = (g.dp[0] > ((size_t) -1) / 2) ? (size_t) -1 : 2 * g.dp[0];
+    grown = *layout;
+    grown.cap0 = (new_dim0 > cap) ? new_dim0 : cap;
+    if ( das(data_size, num_dim, dim, &grown, &stats, err_code) == 0 ||
+        geom(data_size, num_dim, dim, &grown, &h, err_code) < 0 )
+    {
+        return NULL;
+    }
+    if ( stats.size > ((size_t) -1) - base_off - 2 * HUGE_PAGE )
+    {
+        *err_code = ERRS_SIZE_OVERFLOW;
+        return NULL;
+    }
+    new_len = (base_off + stats.size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+    new_off = base_off;
+    page_kind = map->stats.page_kind;
+
+    /*
+     * mremap() keeps the block at its offset in a page, so its alignment
+     * only up to the page size.  a base relative block aligned to more is
+     * copied to a new mapping instead.
+     */
+    new_map = NULL;
+#if defined(MREMAP_MAYMOVE)
+    if ( !h.rel || h.align <= (size_t) sysconf(_SC_PAGESIZE) )
+    {
+        new_map = (char *) mremap(map->map, map->map_size, new_len, MREMAP_MAYMOVE);
+        if ( new_map == (char *) MAP_FAILED )
+        {
+            new_map = NULL;
+        }
+    }
+#endif
+    old_map = NULL;
+    if ( new_map == NULL )
+    {
+        /* one extra huge page to align the block to a huge page boundary */
+        new_len = (stats.size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE + HUGE_PAGE;
+        new_map = map_anon(new_len, 0);
+        if ( new_map == NULL )
+        {
+            *err_code = ERRS_NO_MEM;
+            return NULL;
+        }
+        new_off = (HUGE_PAGE - (size_t) new_map % HUGE_PAGE) % HUGE_PAGE;
+        memcpy(new_map + new_off + data_off, data_ptr,
+            g.data_bytes / g.dp[0] * dim[0]);
+        /* the old mapping stays until the new block is built */
+        old_map = map->map;
+        page_kind = DAA_PAGE_NORMAL;
+    }
+#if defined(MADV_HUGEPAGE)
+    if ( page_kind == DAA_PAGE_THP )
+    {
+        madvise(new_map + new_off, new_len - new_off, MADV_HUGEPAGE);
+    }
+#endif
+
+    /* the data area may start at another offset in the new block */
+    new_base = new_map + new_off;
+    blk_place(new_base, &h, &data_ptr, &ptr_ptr);
+    if ( (size_t) (data_ptr - new_base) != data_off )
+    {
+        memmove(data_ptr, new_base + data_off, g.data_bytes / g.dp[0] * dim[0]);
+    }
+
+    /* zeroed space, clear what the old block left beyond the live rows */
+    live = data_ptr + g.data_bytes / g.dp[0] * dim[0];
+    end = new_base + g.size;
+    if ( (grown.flags & DAA_ZEROED) && end > live )
+    {
+        if ( end > data_ptr + h.data_bytes )
+        {
+            end = data_ptr + h.data_bytes;
+        }
+        memset(live, 0, (size_t) (end - live));
+    }
+
+    /* the pointers for the new capacity, before map and layout change */
+    if ( daa(data_size, num_dim, dim, st, &grown, err_code, new_base, NULL) == NULL )
+    {
+        if ( old_map != NULL )
+        {
+            munmap(new_map, new_len);
+            return NULL;
+        }
+        /* not reached, mremap() kept the alignment; the old mapping is gone */
+        map->map = new_map;
+        map->map_size = new_len;
+        map->base = new_base;
+        map->stats.page_kind = page_kind;
+        return NULL;
+    }
+    if ( old_map != NULL )
+    {
+        munmap(old_map, map->map_size);
+    }
+
+    stats.page_kind = page_kind;
+    map->map = new_map;
+    map->map_size = new_len;
+    map->base = new_base;
+    map->stats = stats;
+    *layout = grown;
+
+    /* then the new elements */
+    return daa_grow(data_size, num_dim, dim, st, layout, err_code, map->base,
+        new_dim0, init_ptr);
+}
+
+} // daa namespace
+
+#endif  // DAA_MMAP_HPP
@@ -0,0 +1,799 @@
+//  daa_pool.hpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#ifndef DAA_POOL_HPP
+#define DAA_POOL_HPP
+
+#include <atomic>
+#include <thread>
+
+#include "daa.hpp"
+
+namespace Daa
+{
+
+const unsigned int POOL_SHAPES = 64; /* daa_pool maximum number of shapes */
+const size_t POOL_HDR = 64;          /* daa_pool block header bytes */
+
+/*
+ *==================================================================================================
+ * File: daa_pool.hpp
+ *
+ * Description:
+ *     daa_pool is a thread safe recycling pool of daa() blocks keyed by
+ *     shape, (data_size, dim, st, layout).  a returned block keeps its
+ *     pointer arrays, which are valid for every later user of the same
+ *     shape, so getting a recycled array is a pop from a free list and no
+ *     pointer is rebuilt.  a new block is built from a daa_plan of the
+ *     shape.
+ *
+ *     each shape has a shared free list under a spin lock, held for a
+ *     pop or push of the list head only, so a get or put is a few pointer
+ *     moves whatever the length of the list and there is no ABA problem.
+ *     a daa_pool_cache is a per thread cache in front of the shared lists,
+ *     its gets and puts are plain list operations.  it refills from, and
+ *     spills half of itself to, the shared list in batches.
+ *
+ *     the shared list of a shape holds at most max_blocks blocks and a
+ *     cache at most cache_max per shape, blocks beyond that are freed.
+ *     trim() frees the blocks held.  stats() reports the hits(gets served
+ *     from a list), the misses(gets that built a new block) and the blocks
+ *     held, the counts of a cache are added to the pool when it is
+ *     flushed or destroyed.
+ *
+ *     requires C++11(std::atomic).  compile with -pthread.
+ *
+ * Examples:
+ *     see daa_test.cpp
+ *
+ *==================================================================================================
+ */
+
+/*
+ * daa_pool_stats:
+ *     counts of a daa_pool shape, see daa_pool::stats().
+ */
+
+struct daa_pool_stats
+{
+    size_t hits;     /* gets served from a free list */
+    size_t misses;   /* gets that built a new block */
+    size_t blocks;   /* blocks on the shared free list */
+};
+
+/*
+ * pool_blk:
+ *     header of a pooled block, POOL_HDR(or the layout align) bytes before
+ *     the daa() block.
+ */
+
+struct pool_blk
+{
+    pool_blk *next;  /* next block of a free list */
+};
+
+/*
+ * pool_shape:
+ *     one shape of a daa_pool, its plan and its shared free list.
+ */
+
+struct pool_shape
+{
+    std::atomic<int> state;         /* 0 free, 1 being made, 2 ready */
+    daa_plan plan;                  /* the plan, and the shape key */
+    daa_layout layout;              /* the layout, part of the key */
+    size_t size;                    /* das() size */
+    size_t hdr;                     /* header bytes before the block */
+    ptrdiff_t top_off;              /* daa() pointer - block start */
+    std::atomic_flag lock;          /* held to change the shared free list */
+    pool_blk *free;                 /* the shared free list */
+    std::atomic<size_t> count;      /* blocks on it, changed under the lock */
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+};
+
+class daa_pool_cache;
+
+class daa_pool
+{
+    friend class daa_pool_cache;
+
+public:
+
+    /*
+     * daa_pool:
+     *     an empty pool.
+     *
+     * Arguments:
+     *     size_t max_blocks
+     *        the most blocks a shared free list holds.
+     */
+
+    explicit daa_pool(
+        size_t max_blocks = 1024)
+        : shapes_(new pool_shape[POOL_SHAPES]), max_blocks_(max_blocks)
+    {
+        unsigned int i;
+
+
+        for ( i = 0 ; i < POOL_SHAPES ; i++ )
+        {
+            shapes_[i].state.store(0);
+            shapes_[i].plan.tmpl = NULL;
+            shapes_[i].lock.clear();
+            shapes_[i].free = NULL;
+            shapes_[i].count.store(0);
+            shapes_[i].hits.store(0);
+            shapes_[i].misses.store(0);
+        }
+    }
+
+    daa_pool(const daa_pool &) = delete;
+    daa_pool &operator=(const daa_pool &) = delete;
+
+    /*
+     * ~daa_pool:
+     *     free every block held and the plans.  the caches of the pool must
+     *     be destroyed first, and arrays still in use are not freed.
+     */
+
+    ~daa_pool()
+    {
+        unsigned int i;
+
+
+        trim();
+        for ( i = 0 ; i < POOL_SHAPES ; i++ )
+        {
+            daa_plan_free(&shapes_[i].plan);
+        }
+        delete [] shapes_;
+    }
+
+    /*
+     * shape:
+     *     the shape id of (data_size, dim, st, layout), made on first use.
+     *     the plan of the shape is made and one block built, which also
+     *     checks the shape.  several threads may call shape() at once, a
+     *     shape is made only once.
+     *
+     * Arguments:
+     *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+     *     const daa_layout *layout, int *err_code
+     *        see daa().
+     *
+     * Returns:
+     *     the shape id, or -1 and an error code in *err_code, see das(),
+     *     ERRS_NO_MEM and ERRS_CAPACITY for more than POOL_SHAPES shapes.
+     */
+
+        int
+    shape(
+        size_t data_size,
+        unsigned int num_dim,
+        size_t *dim,
+        ptrdiff_t *st,
+        const daa_layout *layout,
+        int *err_code)
+    {
+        unsigned int i;
+        int state;
+
+
+        /* the slots are made in order, so a shape is in the first slot that has it */
+        i = 0;
+        while ( i < POOL_SHAPES )
+        {
+            pool_shape &s = shapes_[i];
+
+            state = 0;
+            if ( s.state.compare_exchange_strong(state, 1, std::memory_order_acquire) )
+            {
+                if ( make(s, data_size, num_dim, dim, st, layout, err_code) < 0 )
+                {
+                    /* leave the slot free for the next shape */
+                    s.state.store(0, std::memory_order_release);
+                    return -1;
+                }
+                s.state.store(2, std::memory_order_release);
+                return (int) i;
+            }
+
+            /* wait for a slot being made, it may be this shape */
+            while ( (state = s.state.load(std::memory_order_acquire)) == 1 )
+            {
+                std::this_thread::yield();
+            }
+            if ( state == 2 )
+            {
+                if ( same(s, data_size, num_dim, dim, st, layout) )
+                {
+                    return (int) i;
+                }
+                i++;
+            }
+        }
+
+        *err_code = ERRS_CAPACITY;
+        return -1;
+    }
+
+    /*
+     * get:
+     *     an array of shape id from the shared free list, or a new one.
+     *
+     * Arguments:
+     *     int id
+     *        the shape id.
+     *
+     *     int *err_code
+     *        index to returned error code string in daa_errs[].
+     *
+     *     char *init_ptr
+     *        initialization pointer parameter, NULL for none.  a recycled
+     *        array otherwise holds the values it was put with.
+     *
+     * Returns:
+     *     the daa() array pointer, or NULL and ERRS_NO_MEM in *err_code.
+     */
+
+        void *
+    get(
+        int id,
+        int *err_code,
+        char *init_ptr = NULL)
+    {
+        pool_shape &s = shapes_[id];
+        pool_blk *b;
+        size_t n;
+
+
+        b = take(s, 1, &n);
+        if ( b == NULL )
+        {
+            s.misses.fetch_add(1, std::memory_order_relaxed);
+            return build(s, err_code, init_ptr);
+        }
+        s.hits.fetch_add(1, std::memory_order_relaxed);
+
+        return reuse(s, b, init_ptr);
+    }
+
+    /*
+     * put:
+     *     return an array of shape id to the shared free list, or free it
+     *     if the list is full.
+     *
+     * Arguments:
+     *     int id
+     *        the shape id.
+     *
+     *     void *array
+     *        an array of the shape from get().
+     */
+
+        void
+    put(
+        int id,
+        void *array)
+    {
+        pool_shape &s = shapes_[id];
+        pool_blk *b = blk(s, array);
+
+
+        b->next = NULL;
+        keep(s, b, b, 1);
+    }
+
+    /*
+     * trim:
+     *     free every block on the shared free lists.
+     */
+
+        void
+    trim()
+    {
+        unsigned int i;
+        pool_blk *b;
+        pool_blk *next;
+        size_t n;
+
+
+        for ( i = 0 ; i < POOL_SHAPES ; i++ )
+        {
+            for ( b = take(shapes_[i], (size_t) -1, &n) ; b != NULL ; b = next )
+            {
+                next = b->next;
+                daa_free(b);
+            }
+        }
+    }
+
+    /*
+     * stats:
+     *     the counts of shape id.
+     */
+
+        daa_pool_stats
+    stats(
+        int id) const
+    {
+        daa_pool_stats st;
+
+
+        st.hits = shapes_[id].hits.load(std::memory_order_relaxed);
+        st.misses = shapes_[id].misses.load(std::memory_order_relaxed);
+        st.blocks = shapes_[id].count.load(std::memory_order_relaxed);
+
+        return st;
+    }
+
+private:
+
+    pool_shape *shapes_;   /* POOL_SHAPES shapes */
+    size_t max_blocks_;    /* shared free list limit */
+
+    /*
+     * make:
+     *     make shape s, its plan and its first block, which goes on the
+     *     shared free list.
+     */
+
+        int
+    make(
+        pool_shape &s,
+        size_t data_size,
+        unsigned int num_dim,
+        size_t *dim,
+        ptrdiff_t *st,
+        const daa_layout *layout,
+        int *err_code)
+    {
+        char *mem;
+        char *array;
+
+
+        daa_plan_free(&s.plan);
+        s.size = daa_plan_init(data_size, num_dim, dim, st, layout, err_code, &s.plan);
+        if ( s.size == 0 )
+        {
+            return -1;
+        }
+        s.layout.flags = 0;
+        s.layout.align = 0;
+        s.layout.cap0 = 0;
+        if ( layout != NULL )
+        {
+            s.layout = *layout;
+        }
+        s.hdr = (s.plan.g.align > POOL_HDR) ? s.plan.g.align : POOL_HDR;
+
+        mem = (char *) daa_alloc(s.hdr + s.size, s.hdr);
+        if ( mem == NULL )
+        {
+            *err_code = ERRS_NO_MEM;
+            return -1;
+        }
+        array = (char *) daa_plan_build(&s.plan, err_code, mem + s.hdr, NULL);
+        if ( array == NULL )
+        {
+            daa_free(mem);
+            return -1;
+        }
+        s.top_off = array - (mem + s.hdr);
+        push(s, (pool_blk *) mem, (pool_blk *) mem, 1);
+
+        return 0;
+    }
+
+    /*
+     * same:
+     *     true if shape s is (data_size, dim, st, layout).
+     */
+
+        static bool
+    same(
+        const pool_shape &s,
+        size_t data_size,
+        unsigned int num_dim,
+        size_t *dim,
+        ptrdiff_t *st,
+        const daa_layout *layout)
+    {
+        unsigned int i;
+
+
+        if ( s.plan.data_size != data_size || s.plan.num_dim != num_dim )
+        {
+            return false;
+        }
+        for ( i = 0 ; i < num_dim ; i++ )
+        {
+            if ( s.plan.dim[i] != dim[i] || s.plan.st[i] != st[i] )
+            {
+                return false;
+            }
+        }
+        if ( layout == NULL )
+        {
+            return s.layout.flags == 0 && s.layout.align == 0 && s.layout.cap0 == 0;
+        }
+
+        return s.layout.flags == layout->flags && s.layout.align == layout->align &&
+            s.layout.cap0 == layout->cap0;
+    }
+
+    /*
+     * build:
+     *     a new block of shape s, built from the plan.  the block starts
+     *     s.hdr bytes into the allocation, after the pool_blk header.
+     */
+
+        static void *
+    build(
+        pool_shape &s,
+        int *err_code,
+        char *init_ptr)
+    {
+        char *mem;
+        void *array;
+
+
+        mem = (char *) daa_alloc(s.hdr + s.size, s.hdr);
+        if ( mem == NULL )
+        {
+            *err_code = ERRS_NO_MEM;
+            return NULL;
+        }
+        array = daa_plan_build(&s.plan, err_code, mem + s.hdr, init_ptr);
+        if ( array == NULL )
+        {
+            daa_free(mem);
+        }
+
+        return array;
+    }
+
+    /*
+     * reuse:
+     *     the array of the recycled block b of shape s, initialized if
+     *     init_ptr is not NULL.  the pointers are left as they are.
+     */
+
+        static void *
+    reuse(
+        pool_shape &s,
+        pool_blk *b,
+        char *init_ptr)
+    {
+        char *data_ptr;
+        char *ptr_ptr;
+
+
+        if ( init_ptr != NULL )
+        {
+            blk_place((char *) b + s.hdr, &s.plan.g, &data_ptr, &ptr_ptr);
+            blk_fill(data_ptr, s.plan.data_size, s.plan.num_dim, s.plan.dim, &s.plan.g,
+                init_ptr, 0, s.plan.dim[0]);
+        }
+
+        return (char *) b + s.hdr + s.top_off;
+    }
+
+    /*
+     * blk:
+     *     the header of the block of an array of shape s.
+     */
+
+        static pool_blk *
+    blk(
+        const pool_shape &s,
+        void *array)
+    {
+        return (pool_blk *) ((char *) array - s.top_off - s.hdr);
+    }
+
+    /*
+     * acquire:
+     *     lock the shared free list of s.  the lock is held for a few
+     *     pointer moves, so a waiter yields and tries again.
+     */
+
+        static void
+    acquire(
+        pool_shape &s)
+    {
+        while ( s.lock.test_and_set(std::memory_order_acquire) )
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /*
+     * release:
+     *     unlock the shared free list of s.
+     */
+
+        static void
+    release(
+        pool_shape &s)
+    {
+        s.lock.clear(std::memory_order_release);
+    }
+
+    /*
+     * push:
+     *     push the list first..last of n blocks on the shared free list of
+     *     s.
+     */
+
+        static void
+    push(
+        pool_shape &s,
+        pool_blk *first,
+        pool_blk *last,
+        size_t n)
+    {
+        acquire(s);
+        last->next = s.free;
+        s.free = first;
+        s.count.store(s.count.load(std::memory_order_relaxed) + n,
+            std::memory_order_relaxed);
+        release(s);
+    }
+
+    /*
+     * take:
+     *     take up to max blocks off the shared free list of s, *n of them.
+     *     one block for a get, a batch for a cache refill, all for trim().
+     */
+
+        static pool_blk *
+    take(
+        pool_shape &s,
+        size_t max,
+        size_t *n)
+    {
+        pool_blk *first;
+        pool_blk *last = NULL;
+        size_t k = 0;
+
+
+        acquire(s);
+        first = s.free;
+        if ( max >= s.count.load(std::memory_order_relaxed) )
+        {
+            /* the whole list, the count says how long it is */
+            k = s.count.load(std::memory_order_relaxed);
+            s.free = NULL;
+        }
+        while ( k < max && s.free != NULL )
+        {
+            last = s.free;
+            s.free = last->next;
+            k++;
+        }
+        if ( last != NULL )
+        {
+            last->next = NULL;
+        }
+        s.count.store(s.count.load(std::memory_order_relaxed) - k,
+            std::memory_order_relaxed);
+        release(s);
+
+        *n = k;
+        return (k > 0) ? first : NULL;
+    }
+
+    /*
+     * keep:
+     *     put the list first..last of n blocks on the shared free list of
+     *     s, freeing them if the list is full.
+     */
+
+        void
+    keep(
+        pool_shape &s,
+        pool_blk *first,
+        pool_blk *last,
+        size_t n)
+    {
+        pool_blk *b;
+
+
+        acquire(s);
+        if ( s.count.load(std::memory_order_relaxed) + n <= max_blocks_ )
+        {
+            last->next = s.free;
+            s.free = first;
+            s.count.store(s.count.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+            release(s);
+            return;
+        }
+        release(s);
+
+        last->next = NULL;
+        while ( first != NULL )
+        {
+            b = first->next;
+            daa_free(first);
+            first = b;
+        }
+    }
+};
+
+/*
+ * daa_pool_cache:
+ *     a per thread cache of a daa_pool.  only the thread that owns the
+ *     cache may use it.  destroy the cache before the pool.
+ */
+
+class daa_pool_cache
+{
+public:
+
+    /*
+     * daa_pool_cache:
+     *     an empty cache of pool.
+     *
+     * Arguments:
+     *     daa_pool &pool
+     *        the pool.
+     *
+     *     size_t cache_max
+     *        the most blocks of a shape the cache holds.
+     */
+
+    explicit daa_pool_cache(
+        daa_pool &pool,
+        size_t cache_max = 64)
+        : pool_(pool), cache_max_(cache_max > 0 ? cache_max : 1)
+    {
+        unsigned int i;
+
+
+        for ( i = 0 ; i < POOL_SHAPES ; i++ )
+        {
+            head_[i] = NULL;
+            count_[i] = 0;
+            hits_[i] = 0;
+            misses_[i] = 0;
+        }
+    }
+
+    daa_pool_cache(const daa_pool_cache &) = delete;
+    daa_pool_cache &operator=(const daa_pool_cache &) = delete;
+
+    ~daa_pool_cache()
+    {
+        flush();
+    }
+
+    /*
+     * get:
+     *     an array of shape id, see daa_pool::get().  from the cache, else
+     *     from a batch of the shared free list, else a new one.
+     */
+
+        void *
+    get(
+        int id,
+        int *err_code,
+        char *init_ptr = NULL)
+    {
+        pool_shape &s = pool_.shapes_[id];
+        pool_blk *b = head_[id];
+
+
+        if ( b == NULL )
+        {
+            /* refill with half the cache, a put does not spill at once */
+            b = daa_pool::take(s, (cache_max_ + 1) / 2, &count_[id]);
+            if ( b == NULL )
+            {
+                misses_[id]++;
+                return daa_pool::build(s, err_code, init_ptr);
+            }
+        }
+
+        head_[id] = b->next;
+        count_[id]--;
+        hits_[id]++;
+
+        return daa_pool::reuse(s, b, init_ptr);
+    }
+
+    /*
+     * put:
+     *     return an array of shape id to the cache.  a full cache first
+     *     spills half of its blocks of the shape to the pool.
+     */
+
+        void
+    put(
+        int id,
+        void *array)
+    {
+        pool_blk *b = daa_pool::blk(pool_.shapes_[id], array);
+
+
+        if ( count_[id] >= cache_max_ )
+        {
+            spill(id, count_[id] - count_[id] / 2);
+        }
+        b->next = head_[id];
+        head_[id] = b;
+        count_[id]++;
+    }
+
+    /*
+     * flush:
+     *     return every block of the cache to the pool and add the cache
+     *     counts to the pool counts.
+     */
+
+        void
+    flush()
+    {
+        unsigned int i;
+
+
+        for ( i = 0 ; i < POOL_SHAPES ; i++ )
+        {
+            if ( count_[i] > 0 )
+            {
+                spill(i, count_[i]);
+            }
+            pool_.shapes_[i].hits.fetch_add(hits_[i], std::memory_order_relaxed);
+            pool_.shapes_[i].misses.fetch_add(misses_[i], std::memory_order_relaxed);
+            hits_[i] = 0;
+            misses_[i] = 0;
+        }
+    }
+
+private:
+
+    daa_pool &pool_;                  /* the pool */
+    size_t cache_max_;                /* blocks of a shape held */
+    pool_blk *head_[POOL_SHAPES];     /* free list of each shape */
+    size_t count_[POOL_SHAPES];       /* blocks on it */
+    size_t hits_[POOL_SHAPES];        /* counts not yet in the pool */
+    size_t misses_[POOL_SHAPES];
+
+    /*
+     * spill:
+     *     move n blocks of shape id to the pool.
+     */
+
+        void
+    spill(
+        unsigned int id,
+        size_t n)
+    {
+        pool_blk *first = head_[id];
+        pool_blk *last = first;
+        size_t k;
+
+
+        for ( k = 1 ; k < n ; k++ )
+        {
+            last = last->next;
+        }
+        head_[id] = last->next;
+        count_[id] -= n;
+        pool_.keep(pool_.shapes_[id], first, last, n);
+    }
+};
+
+} // daa namespace
+
+#endif  // DAA_POOL_HPP
@@ -0,0 +1,551 @@
+//  daa_thread.hpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#ifndef DAA_THREAD_HPP
+#define DAA_THREAD_HPP
+
+#include <thread>
+#include <vector>
+#include <system_error>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(DAA_NUMA)
+#include <numaif.h>
+#endif
+
+#include "daa.hpp"
+
+namespace Daa
+{
+
+const int PLACE_MAX_NODE = 1024; /* daa_place() highest NUMA node + 1 */
+
+/*
+ *==================================================================================================
+ * File: daa_thread.hpp
+ *
+ * Description:
+ *     multi-threaded versions of the daa.hpp routines.  daa_parallel()
+ *     produces exactly the same bytes as daa(), but divides the data
+ *     initialization and the pointer array construction across threads.
+ *     the work is split into ranges of units, a unit being one element of
+ *     the pointer array of the lowest level that has at least as many
+ *     elements as there are threads(see ptr_rows() in daa.hpp).  the data
+ *     and the pointers under a unit range are contiguous, so each thread
+ *     writes its own separate parts of every level.
+ *
+ *     daa_place() is the NUMA placement version.  it divides the array
+ *     into slabs of the outermost dimension, one per worker thread, and
+ *     each worker, optionally pinned to a cpu, first touches the data and
+ *     the pointers of its slab.  with a first touch page placement policy
+ *     the pages of a slab are then local to the node of the worker's cpu.
+ *     daa_slab() gives the same partition to the code that later
+ *     processes the slabs.  compiled with DAA_NUMA defined(link with
+ *     -lnuma), daa_place() can also bind each slab explicitly to a node
+ *     with mbind().
+ *
+ *     requires C++11(std::thread).  compile with -pthread.  cpu pinning is
+ *     done on linux only.
+ *
+ * Examples:
+ *     see daa_test.cpp
+ *
+ *==================================================================================================
+ */
+
+/*
+ * par_level:
+ *     choose the level whose pointer array elements are the units of work
+ *     for nthreads threads, the lowest level with at least nthreads
+ *     elements, or the last pointer level.
+ *
+ * Arguments:
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dp
+ *        array of dimension products.
+ *
+ *     unsigned int nthreads
+ *        number of threads.
+ *
+ * Returns:
+ *     the unit level.  0 for a one dimensional array, whose units are data
+ *     items.
+ */
+
+    static unsigned int
+par_level(
+    unsigned int num_dim,
+    size_t *dp,
+    unsigned int nthreads)
+{
+    unsigned int level;
+
+
+    for ( level = 0 ; level + 2 < num_dim ; level++ )
+    {
+        if ( dp[level] >= nthreads )
+        {
+            break;
+        }
+    }
+
+    return level;
+}
+
+/*
+ * par_rows:
+ *     one thread's share of daa_parallel(), initialize the data and build
+ *     the pointers under units u0 to u1-1 of level row_level.
+ *
+ * Arguments:
+ *     see ptr_rows() in daa.hpp.
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ */
+
+    static void
+par_rows(
+    size_t data_size,
+    unsigned int num_dim,
+    char *data_ptr,
+    char *ptr_ptr,
+    size_t *dim,
+    ptrdiff_t *st,
+    size_t *dp,
+    unsigned int row_level,
+    size_t u0,
+    size_t u1,
+    char *init_ptr)
+{
+    /* data items under one unit */
+    size_t unit_items = dp[num_dim-1] / dp[row_level];
+
+
+    if ( init_ptr != NULL )
+    {
+        data_fill(data_ptr + u0 * unit_items * data_size,
+            (u1 - u0) * unit_items, data_size, init_ptr);
+    }
+
+    if ( num_dim > 1 )
+    {
+        ptr_rows(data_size, dim[num_dim-1] * data_size, num_dim, data_ptr,
+            ptr_ptr, dim, st, dp, row_level, u0, u1);
+    }
+}
+
+/*
+ * daa_slab:
+ *     the slab of worker w of nworkers, units u0 to u1-1 of 0 to units-1.
+ *     slabs are contiguous and their sizes differ by at most one.
+ *     daa_parallel() and daa_place() use this partition, a caller can use
+ *     it to process an array with the same partition that placed it.
+ *
+ * Arguments:
+ *     size_t units
+ *        number of units, e.g. dim[0].
+ *
+ *     unsigned int nworkers
+ *        number of workers, > 0.
+ *
+ *     unsigned int w
+ *        worker, 0 to nworkers-1.
+ *
+ *     size_t *u0, *u1
+ *        returned first and one past last unit of the slab, 0 based.  add
+ *        st[0] for subscripts.
+ */
+
+    inline void
+daa_slab(
+    size_t units,
+    unsigned int nworkers,
+    unsigned int w,
+    size_t *u0,
+    size_t *u1)
+{
+    *u0 = units / nworkers * w + units % nworkers * w / nworkers;
+    *u1 = units / nworkers * (w + 1) + units % nworkers * (w + 1) / nworkers;
+}
+
+/*
+ * par_for:
+ *     run f(w, u0, u1) for the nworkers slabs of units on separate
+ *     threads.  if caller is true the calling thread runs slab 0, else
+ *     it only waits.  if a thread cannot be started its slab is run by
+ *     the calling thread.
+ *
+ * Arguments:
+ *     unsigned int nworkers
+ *        number of workers, > 0 and <= units.
+ *
+ *     size_t units
+ *        number of units.
+ *
+ *     bool caller
+ *        the calling thread runs slab 0.
+ *
+ *     F f
+ *        function of (unsigned int w, size_t u0, size_t u1).
+ */
+
+template <class F>
+    static void
+par_for(
+    unsigned int nworkers,
+    size_t units,
+    bool caller,
+    F f)
+{
+    unsigned int w;
+    size_t u0, u1;
+    std::vector<std::thread> threads;
+
+
+    /* only the thread constructor may throw below, not the vector growth */
+    threads.reserve(nworkers);
+    for ( w = caller ? 1 : 0 ; w < nworkers ; w++ )
+    {
+        daa_slab(units, nworkers, w, &u0, &u1);
+
+        try
+        {
+            threads.push_back(std::thread(f, w, u0, u1));
+        }
+        catch ( const std::system_error & )
+        {
+            f(w, u0, u1);
+        }
+    }
+
+    if ( caller )
+    {
+        daa_slab(units, nworkers, 0, &u0, &u1);
+        f(0, u0, u1);
+    }
+
+    for ( w = 0 ; w < threads.size() ; w++ )
+    {
+        threads[w].join();
+    }
+}
+
+/*
+ * par_workers:
+ *     the number of workers for units, nworkers or hardware concurrency if
+ *     0, at most units.
+ */
+
+    static unsigned int
+par_workers(
+    unsigned int nworkers,
+    size_t units)
+{
+    if ( nworkers == 0 )
+    {
+        nworkers = std::thread::hardware_concurrency();
+        if ( nworkers == 0 )
+        {
+            nworkers = 1;
+        }
+    }
+
+    if ( nworkers > units )
+    {
+        nworkers = (unsigned int) units;
+    }
+
+    return nworkers;
+}
+
+/*
+ * daa_parallel:
+ *     dynamic array allocator, multi-threaded.  takes the same arguments
+ *     as the size_t version of daa() plus a thread count, and produces the
+ *     same array.  the calling thread does one share of the work.  if a
+ *     thread cannot be started its share is done by the calling thread.
+ *
+ * Arguments:
+ *     size_t data_size
+ *        size of the basic array data object.  this will usually be
+ *        obtained from the sizeof() function.
+ *
+ *     unsigned int num_dim
+ *        number of array dimensions.
+ *
+ *     size_t *dim
+ *        a single dimensional array of the dimensions of the array to
+ *        be allocated.
+ *
+ *     ptrdiff_t *st
+ *        a single dimensional array of integer start subscripts for
+ *        each corresponding dimension of the dim array, elements may
+ *        be negative.
+ *
+ *     int *err_code
+ *        index to returned error code string in daa_errs[].
+ *
+ *     char *base_ptr
+ *        pointer to the array space, the size returned by das().
+ *
+ *     char *init_ptr
+ *        initialization pointer parameter.
+ *
+ *     unsigned int nthreads
+ *        number of threads, 0 for std::thread::hardware_concurrency().
+ *
+ * Returns:
+ *     see daa().
+ */
+
+    inline void *
+daa_parallel(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr,
+    unsigned int nthreads)
+{
+    unsigned int row_level;
+
+    /* product of dimensions from 0 to index, dim[0]*dim[1]...dim[index] */
+    size_t dp[MAX_DIM];
+
+    /* points to base of pointers to pointers to ... to data */
+    char *ptr_ptr;
+
+
+    /* validate and set dp[] from dim[] input array */
+    if ( das(data_size, num_dim, dim, err_code) == 0 ||
+        dim_prod(data_size, num_dim, dim, dp, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    ptr_ptr = ptr_start(base_ptr, dp[num_dim-1] * data_size);
+
+    nthreads = par_workers(nthreads, dp[num_dim-1]);
+    row_level = par_level(num_dim, dp, nthreads);
+    nthreads = par_workers(nthreads, dp[row_level]);
+
+    par_for(nthreads, dp[row_level], true,
+        [&](unsigned int, size_t u0, size_t u1)
+        {
+            par_rows(data_size, num_dim, base_ptr, ptr_ptr, dim, st, dp,
+                row_level, u0, u1, init_ptr);
+        });
+
+    return ptr_top(data_size, num_dim, base_ptr, ptr_ptr, st);
+}
+
+/*
+ * place_mem:
+ *     place the pages of len bytes at p for worker thread of daa_place().
+ *     the pages wholly inside the range are bound to node if node >= 0 and
+ *     DAA_NUMA is defined.  if touch is true the first byte of every page
+ *     of the range is written so that the pages are allocated by this
+ *     thread.
+ *
+ * Arguments:
+ *     char *p
+ *        start of the range.
+ *
+ *     size_t len
+ *        byte length of the range.
+ *
+ *     int node
+ *        NUMA node, or -1 for no binding.
+ *
+ *     bool touch
+ *        first touch the pages.
+ */
+
+    static void
+place_mem(
+    char *p,
+    size_t len,
+    int node,
+    bool touch)
+{
+    size_t page = 4096;
+    char *p0;
+
+
+#if defined(__unix__)
+    page = (size_t) sysconf(_SC_PAGESIZE);
+#endif
+
+    if ( len == 0 )
+    {
+        return;
+    }
+
+#if defined(DAA_NUMA)
+    /* bind the whole pages of the range */
+    if ( node >= 0 && node < PLACE_MAX_NODE )
+    {
+        unsigned long mask[PLACE_MAX_NODE / (8 * sizeof(unsigned long))] = {0};
+        char *p1;
+
+        p0 = (char *) (((size_t) p + page - 1) / page * page);
+        p1 = (char *) (((size_t) p + len) / page * page);
+
+        mask[node / (8 * sizeof(unsigned long))] =
+            1UL << (node % (8 * sizeof(unsigned long)));
+        if ( p0 < p1 )
+        {
+            mbind(p0, p1 - p0, MPOL_BIND, mask, PLACE_MAX_NODE, 0);
+        }
+    }
+#else
+    (void) node;
+#endif
+
+    if ( touch )
+    {
+        /* the partial first page, then the start of every other page */
+        *p = 0;
+        for ( p0 = (char *) ((size_t) p / page * page + page) ; p0 < p + len ;
+            p0 += page )
+        {
+            *p0 = 0;
+        }
+    }
+}
+
+/*
+ * daa_place:
+ *     dynamic array allocator, NUMA placement.  takes the same arguments
+ *     as the size_t version of daa() plus a worker count and optional cpu
+ *     and node lists, and produces the same array as daa().  the array is
+ *     divided into nworkers slabs of the outermost dimension(see
+ *     daa_slab()), and worker w pins itself to cpus[w], binds its slab to
+ *     nodes[w], and first touches and builds the data and pointers of its
+ *     slab.  the calling thread only waits, or runs the slab of a worker
+ *     that could not be started, without pinning itself.
+ *
+ *     the space must not have been touched before, e.g. freshly allocated
+ *     by malloc() for large sizes or mmap(), for first touch to place it.
+ *     if init_ptr is NULL, the first byte of each data page is written
+ *     with zero to place it.  the pointers of levels above a slab(the
+ *     level 0 pointer array) are placed with the slab of their first
+ *     element.
+ *
+ * Arguments:
+ *     size_t data_size, unsigned int num_dim, size_t *dim, ptrdiff_t *st,
+ *     int *err_code, char *base_ptr, char *init_ptr
+ *        see daa().
+ *
+ *     unsigned int nworkers
+ *        number of workers, 0 for std::thread::hardware_concurrency().  at
+ *        most dim[0] are used.
+ *
+ *     const int *cpus
+ *        cpu for each worker, or NULL to not pin the workers.
+ *
+ *     const int *nodes
+ *        NUMA node for each worker, or NULL to not bind the slabs.  needs
+ *        DAA_NUMA, otherwise ignored.
+ *
+ * Returns:
+ *     see daa().
+ */
+
+    inline void *
+daa_place(
+    size_t data_size,
+    unsigned int num_dim,
+    size_t *dim,
+    ptrdiff_t *st,
+    int *err_code,
+    char *base_ptr,
+    char *init_ptr,
+    unsigned int nworkers,
+    const int *cpus,
+    const int *nodes)
+{
+    /* product of dimensions from 0 to index, dim[0]*dim[1]...dim[index] */
+    size_t dp[MAX_DIM];
+
+    /* points to base of pointers to pointers to ... to data */
+    char *ptr_ptr;
+
+    /* the calling thread, which runs a worker par_for() could not start */
+    std::thread::id caller = std::this_thread::get_id();
+
+
+    /* validate and set dp[] from dim[] input array */
+    if ( das(data_size, num_dim, dim, err_code) == 0 ||
+        dim_prod(data_size, num_dim, dim, dp, err_code) < 0 )
+    {
+        return NULL;
+    }
+
+    ptr_ptr = ptr_start(base_ptr, dp[num_dim-1] * data_size);
+
+    nworkers = par_workers(nworkers, dim[0]);
+
+    par_for(nworkers, dim[0], false,
+        [&](unsigned int w, size_t u0, size_t u1)
+        {
+            unsigned int level;
+            int node = (nodes != NULL) ? nodes[w] : -1;
+            size_t n;           /* data items or pointers per slab unit */
+            char **ptrs;
+
+#if defined(__linux__)
+            /* do not pin the calling thread */
+            if ( cpus != NULL && std::this_thread::get_id() != caller )
+            {
+                cpu_set_t set;
+
+                CPU_ZERO(&set);
+                CPU_SET(cpus[w], &set);
+                sched_setaffinity(0, sizeof(set), &set);
+            }
+#endif
+
+            /* data slab */
+            n = dp[num_dim-1] / dim[0];
+            place_mem(base_ptr + u0 * n * data_size, (u1 - u0) * n * data_size,
+                node, init_ptr == NULL);
+
+            /* pointer sub-arrays of the slab at every level */
+            ptrs = (char **) ptr_ptr;
+            for ( level = 0 ; level + 1 < num_dim ; level++ )
+            {
+                n = dp[level] / dim[0];
+                place_mem((char *) (ptrs + u0 * n), (u1 - u0) * n * sizeof(char *),
+                    node, false);
+                ptrs += dp[level];
+            }
+
+            par_rows(data_size, num_dim, base_ptr, ptr_ptr, dim, st, dp, 0,
+                u0, u1, init_ptr);
+        });
+
+    return ptr_top(data_size, num_dim, base_ptr, ptr_ptr, st);
+}
+
+} // daa namespace
+
+#endif  // DAA_THREAD_HPP
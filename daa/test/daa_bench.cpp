@@ -0,0 +1,1574 @@
+//  daa_bench.cpp
+
+//
+//          Copyright Richard Allen Hogaboom 1997 - 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+#include "daa.hpp"
+#include "daa_thread.hpp"
+#include "daa_array.hpp"
+#include "daa_mmap.hpp"
+#include "daa_file.hpp"
+#include "daa_pool.hpp"
+
+/*
+ * benchmark code for das()/daa().  like the tests in daa_test.cpp all the
+ * benchmarks are independent.  times are wall clock and printed to stderr.
+ * absolute numbers depend on the machine, compare the rows of a benchmark.
+ */
+
+/*
+ * results that must not be optimized away are stored here
+ */
+
+volatile double sink;
+
+/*
+ * seconds since an arbitrary start
+ */
+
+    static double
+now()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * used in BENCH 1.  the byte at a time init loop daa() used before
+ * data_fill().
+ */
+
+    static void
+byte_fill(
+    char *p_data,
+    size_t num_elem,
+    size_t data_size,
+    char *init_ptr)
+{
+    size_t i, j;
+    char *p;
+
+
+    for ( i = 0 ; i < num_elem ; i++ )
+    {
+        p = init_ptr;
+        for ( j = 0 ; j < data_size ; j++ )
+        {
+            *p_data++ = *p++;
+        }
+    }
+}
+
+/*
+ * used in BENCH 3.  pin the calling thread to cpu.
+ */
+
+    static void
+pin_cpu(
+    int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void) cpu;
+#endif
+}
+
+/*
+ * used in BENCH 3.  NUMA node of the page at p, -1 if unknown.
+ */
+
+    static int
+page_node(
+    void *p)
+{
+    int node = -1;
+
+#if defined(__linux__)
+    if (syscall(SYS_get_mempolicy, &node, NULL, 0, p, MPOL_F_NODE | MPOL_F_ADDR) != 0)
+    {
+        node = -1;
+    }
+#else
+    (void) p;
+#endif
+
+    return node;
+}
+
+/*
+ * used in BENCH 5.  address of an element through the daa() pointers of a
+ * rank n array, p[idx[0]][idx[1]]...[idx[n-1]] with the rank known only at
+ * run time.
+ */
+
+    static char *
+ptr_at(
+    char *p,
+    unsigned int n,
+    const ptrdiff_t *idx)
+{
+    unsigned int k;
+
+
+    for ( k = 0 ; k + 1 < n ; k++ )
+    {
+        p = ((char **) p)[idx[k]];
+    }
+
+    return p + idx[n-1] * (ptrdiff_t) sizeof(double);
+}
+
+/*
+ * used in BENCH 6.  y += 0.5 * x for one row, rows of any alignment and,
+ * below, rows known to be 64 byte aligned.
+ */
+
+    static void
+row_axpy(
+    float *y,
+    const float *x,
+    size_t n)
+{
+    for (size_t j=0 ; j<n ; j++)
+    {
+        y[j] += 0.5f * x[j];
+    }
+}
+
+    static void
+row_axpy_aligned(
+    float *y,
+    const float *x,
+    size_t n)
+{
+#if defined(__GNUC__)
+    y = (float *) __builtin_assume_aligned(y, 64);
+    x = (const float *) __builtin_assume_aligned(x, 64);
+#endif
+    for (size_t j=0 ; j<n ; j++)
+    {
+        y[j] += 0.5f * x[j];
+    }
+}
+
+/*
+ * used in BENCH 14.  MiB of the len bytes at p resident in memory.
+ */
+
+    static double
+resident_mib(
+    char *p,
+    size_t len)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    char *first = p - (size_t) p % page;
+    size_t n = (size_t) (p + len - first + page - 1) / page;
+    std::vector<unsigned char> vec(n);
+    size_t count = 0;
+
+
+    if ( mincore(first, n * page, &vec[0]) != 0 )
+    {
+        return -1;
+    }
+    for (size_t k=0 ; k<n ; k++)
+    {
+        count += vec[k] & 1;
+    }
+
+    return (double) (count * page) / (1024 * 1024);
+}
+
+/*
+ * used in BENCH 17.  resident set size of the process in MiB, -1 where
+ * it is not known.
+ */
+
+    static double
+rss_mib()
+{
+    double mib = -1;
+#if defined(__linux__)
+    unsigned long size, resident;
+    FILE *fp = fopen("/proc/self/statm", "r");
+
+
+    if ( fp != NULL )
+    {
+        if ( fscanf(fp, "%lu %lu", &size, &resident) == 2 )
+        {
+            mib = (double) resident * (double) sysconf(_SC_PAGESIZE) / (1024 * 1024);
+        }
+        fclose(fp);
+    }
+#endif
+
+    return mib;
+}
+
+   int
+main()
+{
+    using namespace Daa;
+
+    /*
+     * BENCH 1
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        const size_t BYTES = 256*1024*1024;
+        size_t sizes[7] = {1, 2, 4, 8, 16, 24, 40}; /* data sizes */
+        char init[40], zero[40];
+
+        fprintf(stderr, "\nBENCH 1");
+        fprintf(stderr, "\n    1 dimensional array init, 256 MiB of data");
+        fprintf(stderr, "\n    byte at a time loop vs. daa() init(data_fill())");
+        fprintf(stderr, "\n    for an all zero and a non-zero init value\n\n");
+
+        for (int i=0 ; i<40 ; i++)
+        {
+            init[i] = char(i + 1);
+            zero[i] = 0;
+        }
+
+        fprintf(stderr, "data_size   byte loop GB/s   daa() GB/s   daa() zero GB/s\n");
+        for (int s=0 ; s<7 ; s++)
+        {
+            size_t d[1] = {BYTES / sizes[s]}; /* dimensions */
+            ptrdiff_t st[1] = {0}; /* starting subscripts */
+            double t0, t1, t2, t3;
+
+            asize = das(sizes[s], 1, d, &err_code);
+            mem_ptr = (char *)malloc(asize);
+
+            /* fault the pages in so only the fill is timed */
+            memset(mem_ptr, 0xff, asize);
+
+            t0 = now();
+            byte_fill(mem_ptr, d[0], sizes[s], init);
+            t1 = now();
+            daa(sizes[s], 1, d, st, &err_code, mem_ptr, init);
+            t2 = now();
+            daa(sizes[s], 1, d, st, &err_code, mem_ptr, zero);
+            t3 = now();
+
+            fprintf(stderr, "%9lu   %14.2f   %10.2f   %15.2f\n", (unsigned long) sizes[s]
+                , BYTES / (t1 - t0) / 1e9, BYTES / (t2 - t1) / 1e9
+                , BYTES / (t3 - t2) / 1e9);
+            free(mem_ptr);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    /*
+     * BENCH 2
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {64, 1024, 1024}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        unsigned int nthreads[5] = {1, 2, 4, 8, 16}; /* thread counts */
+
+        fprintf(stderr, "\nBENCH 2");
+        fprintf(stderr, "\n    3 dimensional array of double, 512 MiB of data");
+        fprintf(stderr, "\n        dimensions: 64, 1024, 1024");
+        fprintf(stderr, "\n    malloc() plus daa() vs. malloc() plus daa_parallel(),");
+        fprintf(stderr, "\n    first touch page faults included(%u hardware threads)\n\n"
+            , std::thread::hardware_concurrency());
+
+        asize = das(sizeof(double), 3, d, &err_code);
+
+        fprintf(stderr, "threads   daa() s   daa_parallel() s\n");
+        for (int t=0 ; t<5 ; t++)
+        {
+            double t0, t1, t2, t3;
+
+            mem_ptr = (char *)malloc(asize);
+            t0 = now();
+            daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+            t1 = now();
+            free(mem_ptr);
+
+            mem_ptr = (char *)malloc(asize);
+            t2 = now();
+            daa_parallel(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init
+                , nthreads[t]);
+            t3 = now();
+            free(mem_ptr);
+
+            fprintf(stderr, "%7u   %7.3f   %16.3f\n", nthreads[t], t1 - t0, t3 - t2);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    /*
+     * BENCH 3
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr[2];
+
+        size_t d[3] = {64, 1024, 1024}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        double ***array[2]; /* daa() and daa_place() arrays */
+        unsigned int nworkers = std::thread::hardware_concurrency();
+        std::vector<int> cpus;
+
+        fprintf(stderr, "\nBENCH 3");
+        fprintf(stderr, "\n    3 dimensional array of double, 512 MiB of data");
+        fprintf(stderr, "\n        dimensions: 64, 1024, 1024");
+        fprintf(stderr, "\n    built by daa() on one thread vs. by daa_place() with one");
+        fprintf(stderr, "\n    worker per cpu(%u), then each worker, pinned to its cpu, sums"
+            , nworkers);
+        fprintf(stderr, "\n    its slab.  node is the NUMA node of the first page of the slab\n\n");
+
+        if (nworkers == 0 || nworkers > d[0])
+        {
+            nworkers = nworkers == 0 ? 1 : d[0];
+        }
+        for (unsigned int w=0 ; w<nworkers ; w++)
+        {
+            cpus.push_back(int(w));
+        }
+
+        asize = das(sizeof(double), 3, d, &err_code);
+
+        mem_ptr[0] = (char *)malloc(asize);
+        array[0] = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr[0]
+            , (char *)&init);
+
+        mem_ptr[1] = (char *)malloc(asize);
+        array[1] = (double ***) daa_place(sizeof(double), 3, d, st, &err_code, mem_ptr[1]
+            , (char *)&init, nworkers, &cpus[0], NULL);
+
+        fprintf(stderr, "worker   cpu   daa() node   GB/s   daa_place() node   GB/s\n");
+        std::vector<double> gbs[2];
+        std::vector<int> node[2];
+        for (int a=0 ; a<2 ; a++)
+        {
+            std::vector<std::thread> threads;
+
+            gbs[a].resize(nworkers);
+            node[a].resize(nworkers);
+            for (unsigned int w=0 ; w<nworkers ; w++)
+            {
+                threads.push_back(std::thread([&, a, w]()
+                {
+                    size_t u0, u1;
+                    double sum = 0., t0;
+
+                    pin_cpu(cpus[w]);
+                    daa_slab(d[0], nworkers, w, &u0, &u1);
+                    node[a][w] = page_node(&array[a][u0][0][0]);
+
+                    t0 = now();
+                    for (int r=0 ; r<4 ; r++)
+                    {
+                        for (size_t i=u0 ; i<u1 ; i++)
+                        {
+                            for (size_t j=0 ; j<d[1] ; j++)
+                            {
+                                for (size_t k=0 ; k<d[2] ; k++)
+                                {
+                                    sum += array[a][i][j][k];
+                                }
+                            }
+                        }
+                    }
+                    gbs[a][w] = 4. * (u1 - u0) * d[1] * d[2] * sizeof(double)
+                        / (now() - t0) / 1e9;
+                    sink = sum;
+                }));
+            }
+            for (unsigned int w=0 ; w<nworkers ; w++)
+            {
+                threads[w].join();
+            }
+        }
+
+        for (unsigned int w=0 ; w<nworkers ; w++)
+        {
+            fprintf(stderr, "%6u   %3d   %10d   %4.1f   %16d   %4.1f\n", w, cpus[w]
+                , node[0][w], gbs[0][w], node[1][w], gbs[1][w]);
+        }
+        fprintf(stderr, "\n");
+
+        free(mem_ptr[0]);
+        free(mem_ptr[1]);
+    }
+
+    /*
+     * BENCH 4
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {256, 256, 256}; /* dimensions */
+        ptrdiff_t st[3] = {1, 1, 1}; /* starting subscripts */
+        double init = 1.0;
+        double ***raw; /* daa() array pointer */
+        double sum[3] = {0., 0., 0.};
+        double t[4];
+
+        fprintf(stderr, "\nBENCH 4");
+        fprintf(stderr, "\n    3 dimensional array of double, 128 MiB of data");
+        fprintf(stderr, "\n        dimensions: 256, 256, 256");
+        fprintf(stderr, "\n    sum all elements through the daa() pointer, daa_array []");
+        fprintf(stderr, "\n    and daa_array at()\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        raw = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+
+        daa_array<double, 3> array(d, st, &init, &err_code);
+
+        t[0] = now();
+        for (ptrdiff_t i=1 ; i<=256 ; i++)
+        {
+            for (ptrdiff_t j=1 ; j<=256 ; j++)
+            {
+                for (ptrdiff_t k=1 ; k<=256 ; k++)
+                {
+                    sum[0] += raw[i][j][k];
+                }
+            }
+        }
+        t[1] = now();
+        for (ptrdiff_t i=1 ; i<=256 ; i++)
+        {
+            for (ptrdiff_t j=1 ; j<=256 ; j++)
+            {
+                for (ptrdiff_t k=1 ; k<=256 ; k++)
+                {
+                    sum[1] += array[i][j][k];
+                }
+            }
+        }
+        t[2] = now();
+        for (ptrdiff_t i=1 ; i<=256 ; i++)
+        {
+            for (ptrdiff_t j=1 ; j<=256 ; j++)
+            {
+                for (ptrdiff_t k=1 ; k<=256 ; k++)
+                {
+                    sum[2] += array.at(i, j, k);
+                }
+            }
+        }
+        t[3] = now();
+        sink = sum[0] + sum[1] + sum[2];
+
+        fprintf(stderr, "daa() pointer s   daa_array [] s   daa_array at() s\n");
+        fprintf(stderr, "%14.3f   %14.3f   %16.3f\n\n", t[1] - t[0], t[2] - t[1], t[3] - t[2]);
+
+        free(mem_ptr);
+    }
+    /*
+     * BENCH 5
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr;
+
+        const size_t NELEM = 4*1024*1024;  /* elements */
+        const size_t NRAND = 1024*1024;    /* random accesses */
+        size_t dims[5][6] = {{2048, 2048}, {256, 128, 128}, {64, 64, 32, 32}
+            , {32, 16, 16, 16, 32}, {16, 16, 16, 8, 8, 16}}; /* dimensions */
+        ptrdiff_t st[6] = {0, 0, 0, 0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        daa_desc desc;
+
+        fprintf(stderr, "\nBENCH 5");
+        fprintf(stderr, "\n    2 to 6 dimensional arrays of double, 32 MiB of data");
+        fprintf(stderr, "\n    read every element in order and 1M random elements through");
+        fprintf(stderr, "\n    the daa() pointers, rank known only at run time, vs. through");
+        fprintf(stderr, "\n    the dad() descriptor with daa_at().  ns per element\n\n");
+
+        std::vector<ptrdiff_t> ridx(NRAND * 6);
+        srand(1);
+
+        fprintf(stderr, "rank   seq pointer   seq daa_at()   random pointer   random daa_at()\n");
+        for (unsigned int n=2 ; n<=6 ; n++)
+        {
+            size_t *d = dims[n-2];
+            double t[5];
+            double sum = 0.;
+            char *array;
+            ptrdiff_t idx[6];
+
+            mem_ptr = (char *)malloc(das(sizeof(double), n, d, &err_code));
+            array = (char *) daa(sizeof(double), n, d, st, &err_code, mem_ptr, (char *)&init);
+            dad(sizeof(double), n, d, st, NULL, &err_code, mem_ptr, &desc);
+
+            for (size_t r=0 ; r<NRAND ; r++)
+            {
+                for (unsigned int k=0 ; k<n ; k++)
+                {
+                    ridx[r*6 + k] = rand() % d[k];
+                }
+            }
+
+            for (int a=0 ; a<4 ; a++)
+            {
+                t[a] = now();
+                if (a < 2)
+                {
+                    memset(idx, 0, sizeof(idx));
+                    for (size_t e=0 ; e<NELEM ; e++)
+                    {
+                        sum += (a == 0) ? *(double *) ptr_at(array, n, idx)
+                            : *(double *) daa_at(&desc, idx);
+                        for (unsigned int k=n ; k-- > 0 && ++idx[k] == (ptrdiff_t) d[k] ; )
+                        {
+                            idx[k] = 0;
+                        }
+                    }
+                }
+                else
+                {
+                    for (size_t r=0 ; r<NRAND ; r++)
+                    {
+                        sum += (a == 2) ? *(double *) ptr_at(array, n, &ridx[r*6])
+                            : *(double *) daa_at(&desc, &ridx[r*6]);
+                    }
+                }
+            }
+            t[4] = now();
+            sink = sum;
+
+            fprintf(stderr, "%4u   %11.2f   %12.2f   %14.2f   %15.2f\n", n
+                , (t[1] - t[0]) / NELEM * 1e9, (t[2] - t[1]) / NELEM * 1e9
+                , (t[3] - t[2]) / NRAND * 1e9, (t[4] - t[3]) / NRAND * 1e9);
+            free(mem_ptr);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    /*
+     * BENCH 6
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr[2][2];
+
+        size_t d[2] = {32, 1001}; /* dimensions */
+        ptrdiff_t st[2] = {0, 0}; /* starting subscripts */
+        float init = 1.0f;
+        daa_layout layout[2] = {{0, 0}, {DAA_PAD_ROWS, 64}};
+        const char *name[2] = {"daa() default", "align 64, DAA_PAD_ROWS"};
+        const int REPS = 4000;
+
+        fprintf(stderr, "\nBENCH 6");
+        fprintf(stderr, "\n    2 dimensional arrays of float, 125 KiB of data each");
+        fprintf(stderr, "\n        dimensions: 32, 1001");
+        fprintf(stderr, "\n    row kernel y[i][j] += 0.5 * x[i][j] with the default layout, rows");
+        fprintf(stderr, "\n    4004 bytes apart, vs. 64 byte aligned rows padded to 4032 bytes\n\n");
+
+        fprintf(stderr, "layout                   pad bytes   GB/s\n");
+        for (int l=0 ; l<2 ; l++)
+        {
+            float **a[2];
+            daa_stats stats = {0, 0, 0, 0, 0};
+            double t0, t1;
+
+            das(sizeof(float), 2, d, &layout[l], &stats, &err_code);
+            for (int k=0 ; k<2 ; k++)
+            {
+                mem_ptr[l][k] = (char *)malloc(stats.size);
+                a[k] = (float **) daa(sizeof(float), 2, d, st, &layout[l], &err_code
+                    , mem_ptr[l][k], (char *)&init);
+            }
+
+            t0 = now();
+            for (int r=0 ; r<REPS ; r++)
+            {
+                for (size_t i=0 ; i<d[0] ; i++)
+                {
+                    if (l == 0)
+                    {
+                        row_axpy(a[1][i], a[0][i], d[1]);
+                    }
+                    else
+                    {
+                        row_axpy_aligned(a[1][i], a[0][i], d[1]);
+                    }
+                }
+            }
+            t1 = now();
+            sink = a[1][d[0]-1][d[1]-1];
+
+            fprintf(stderr, "%-22s   %9lu   %4.1f\n", name[l], (unsigned long) stats.pad_bytes
+                , 3. * REPS * d[0] * d[1] * sizeof(float) / (t1 - t0) / 1e9);
+            free(mem_ptr[l][0]);
+            free(mem_ptr[l][1]);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    /*
+     * BENCH 7
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {64, 512, 1024}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        const size_t NRAND = 4*1024*1024; /* random accesses */
+        const char *kind[4] = {"unknown", "MAP_HUGETLB", "MADV_HUGEPAGE", "normal"};
+        daa_map map;
+        double ***array[2]; /* malloc() and daa_map_huge() arrays */
+        std::vector<unsigned int> ridx(NRAND * 3);
+
+        fprintf(stderr, "\nBENCH 7");
+        fprintf(stderr, "\n    3 dimensional array of double, 256 MiB of data");
+        fprintf(stderr, "\n        dimensions: 64, 512, 1024");
+        fprintf(stderr, "\n    4M random element reads through the pointers, malloc() space vs.");
+        fprintf(stderr, "\n    daa_map_huge() space.  ns per element\n\n");
+
+        srand(1);
+        for (size_t r=0 ; r<NRAND ; r++)
+        {
+            for (int k=0 ; k<3 ; k++)
+            {
+                ridx[r*3 + k] = rand() % d[k];
+            }
+        }
+
+        mem_ptr = (char *)malloc(das(sizeof(double), 3, d, &err_code));
+        array[0] = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+        array[1] = (double ***) daa_map_huge(sizeof(double), 3, d, st, NULL, &err_code
+            , (char *)&init, &map);
+
+        fprintf(stderr, "space            page kind       ns\n");
+        for (int a=0 ; a<2 ; a++)
+        {
+            double sum = 0., t0, t1;
+
+            if (array[a] == NULL)
+            {
+                continue;
+            }
+            t0 = now();
+            for (size_t r=0 ; r<NRAND ; r++)
+            {
+                sum += array[a][ridx[r*3]][ridx[r*3 + 1]][ridx[r*3 + 2]];
+            }
+            t1 = now();
+            sink = sum;
+
+            fprintf(stderr, "%-14s   %-13s   %4.1f\n", a ? "daa_map_huge()" : "malloc()"
+                , a ? kind[map.stats.page_kind] : "-", (t1 - t0) / NRAND * 1e9);
+        }
+        fprintf(stderr, "\n");
+
+        free(mem_ptr);
+        daa_unmap(&map);
+    }
+
+    /*
+     * BENCH 8
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr[2];
+
+        size_t d[3] = {1024, 1024, 32}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        double t[4];
+
+        fprintf(stderr, "\nBENCH 8");
+        fprintf(stderr, "\n    3 dimensional array of double, 256 MiB of data, 8 MiB of pointers");
+        fprintf(stderr, "\n        dimensions: 1024, 1024, 32");
+        fprintf(stderr, "\n    copy the block with memcpy() and rebuild it with daa() vs.");
+        fprintf(stderr, "\n    memcpy() and daa_rebase() vs. daa_clone()\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr[0] = (char *)malloc(asize);
+        mem_ptr[1] = (char *)malloc(asize);
+        daa(sizeof(double), 3, d, st, &err_code, mem_ptr[0], (char *)&init);
+
+        /* fault the pages in so only the copy is timed */
+        memset(mem_ptr[1], 0, asize);
+
+        t[0] = now();
+        memcpy(mem_ptr[1], mem_ptr[0], asize);
+        daa(sizeof(double), 3, d, st, &err_code, mem_ptr[1], NULL);
+        t[1] = now();
+        memcpy(mem_ptr[1], mem_ptr[0], asize);
+        daa_rebase(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr[0], mem_ptr[1]);
+        t[2] = now();
+        daa_clone(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr[0], mem_ptr[1]);
+        t[3] = now();
+
+        fprintf(stderr, "memcpy() + daa() s   memcpy() + daa_rebase() s   daa_clone() s\n");
+        fprintf(stderr, "%18.3f   %25.3f   %13.3f\n\n", t[1] - t[0], t[2] - t[1], t[3] - t[2]);
+
+        free(mem_ptr[0]);
+        free(mem_ptr[1]);
+    }
+
+    /*
+     * BENCH 9
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *new_ptr;
+        size_t k;
+
+        size_t d[3] = {1, 64, 64}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        float init = 1.0f;
+        daa_layout layout = {0, 0, 1};
+        daa_map map;
+        double t[3];
+
+        fprintf(stderr, "\nBENCH 9");
+        fprintf(stderr, "\n    3 dimensional array of float, append 1024 elements of dimension 0");
+        fprintf(stderr, "\n    one at a time");
+        fprintf(stderr, "\n        dimensions: 1 to 1024, 64, 64");
+        fprintf(stderr, "\n    malloc() a larger block, daa() and memcpy() the data vs.");
+        fprintf(stderr, "\n    daa_map_resize()\n\n");
+
+        t[0] = now();
+        asize = das(sizeof(float), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        daa(sizeof(float), 3, d, st, &err_code, mem_ptr, (char *)&init);
+        for (k = 2; k <= 1024; k++)
+        {
+            size_t old_dim0 = d[0];
+            char *old_data;
+            char *new_data;
+
+            d[0] = k;
+            asize = das(sizeof(float), 3, d, &err_code);
+            new_ptr = (char *)malloc(asize);
+            new_data = (char *) &((float ***) daa(sizeof(float), 3, d, st, &err_code
+                , new_ptr, NULL))[0][0][0];
+            d[0] = old_dim0;
+            old_data = (char *) &((float ***) daa(sizeof(float), 3, d, st, &err_code
+                , mem_ptr, NULL))[0][0][0];
+            memcpy(new_data, old_data, old_dim0 * 64 * 64 * sizeof(float));
+            for (size_t j = 0; j < 64 * 64; j++)
+            {
+                ((float *) new_data)[old_dim0 * 64 * 64 + j] = init;
+            }
+            d[0] = k;
+            free(mem_ptr);
+            mem_ptr = new_ptr;
+        }
+        t[1] = now();
+        free(mem_ptr);
+
+        d[0] = 1;
+        daa_map_huge(sizeof(float), 3, d, st, &layout, &err_code, (char *)&init, &map);
+        for (k = 2; k <= 1024; k++)
+        {
+            daa_map_resize(sizeof(float), 3, d, st, &layout, &err_code, (char *)&init, k
+                , &map);
+        }
+        t[2] = now();
+        daa_unmap(&map);
+
+        fprintf(stderr, "malloc() + daa() + memcpy() s   daa_map_resize() s\n");
+        fprintf(stderr, "%28.3f   %18.3f\n\n", t[1] - t[0], t[2] - t[1]);
+    }
+
+    /*
+     * BENCH 10
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr[2];
+
+        size_t d[4] = {16, 64, 128, 128}; /* dimensions */
+        ptrdiff_t st[4] = {0, 0, 0, 0}; /* starting subscripts */
+        double init = 1.0;
+        const size_t NRAND = 4*1024*1024; /* random walks */
+        daa_layout layout[2] = {{0, 0, 0}, {DAA_PTRS_FIRST, 64, 0}};
+        const char *name[2] = {"data first", "DAA_PTRS_FIRST"};
+        std::vector<unsigned int> ridx(NRAND * 4);
+
+        fprintf(stderr, "\nBENCH 10");
+        fprintf(stderr, "\n    4 dimensional array of double, 128 MiB of data, 1 MiB of pointers");
+        fprintf(stderr, "\n        dimensions: 16, 64, 128, 128");
+        fprintf(stderr, "\n    4M random pointer walks to a last level row, and 4M random element");
+        fprintf(stderr, "\n    reads, data first vs. pointers first layout.  the offset of the top");
+        fprintf(stderr, "\n    level pointer array in the block and ns per walk or read\n\n");
+
+        srand(1);
+        for (size_t r=0 ; r<NRAND ; r++)
+        {
+            for (int k=0 ; k<4 ; k++)
+            {
+                ridx[r*4 + k] = rand() % d[k];
+            }
+        }
+
+        fprintf(stderr, "layout             top offset   walk ns   read ns\n");
+        for (int l=0 ; l<2 ; l++)
+        {
+            double ****a;
+            size_t rows = 0;
+            double sum = 0., t0, t1, t2;
+
+            mem_ptr[l] = (char *)malloc(das(sizeof(double), 4, d, &layout[l], &err_code));
+            a = (double ****) daa(sizeof(double), 4, d, st, &layout[l], &err_code, mem_ptr[l]
+                , (char *)&init);
+
+            t0 = now();
+            for (size_t r=0 ; r<NRAND ; r++)
+            {
+                rows += (size_t) a[ridx[r*4]][ridx[r*4 + 1]][ridx[r*4 + 2]];
+            }
+            t1 = now();
+            for (size_t r=0 ; r<NRAND ; r++)
+            {
+                sum += a[ridx[r*4]][ridx[r*4 + 1]][ridx[r*4 + 2]][ridx[r*4 + 3]];
+            }
+            t2 = now();
+            sink = sum + (double) rows;
+
+            fprintf(stderr, "%-14s   %12lu   %7.1f   %7.1f\n", name[l]
+                , (unsigned long) ((char *) a - mem_ptr[l]), (t1 - t0) / NRAND * 1e9
+                , (t2 - t1) / NRAND * 1e9);
+        }
+        fprintf(stderr, "\n");
+
+        free(mem_ptr[0]);
+        free(mem_ptr[1]);
+    }
+
+    /*
+     * BENCH 11
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr;
+        void *array;
+
+        size_t d[3] = {16, 16, 8}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        const size_t NARR = 200000; /* arrays allocated */
+        daa_plan plan;
+        size_t asize = 0;
+        double t[3];
+        size_t sum = 0;
+
+        fprintf(stderr, "\nBENCH 11");
+        fprintf(stderr, "\n    3 dimensional array of double, 16 KiB of data, 272 pointers");
+        fprintf(stderr, "\n        dimensions: 16, 16, 8");
+        fprintf(stderr, "\n    200000 uninitialized arrays of the same shape, das()/malloc()/daa()/");
+        fprintf(stderr, "\n    free() vs. malloc()/daa_plan_build()/free() with one plan.  ns per");
+        fprintf(stderr, "\n    array\n\n");
+
+        t[0] = now();
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            mem_ptr = (char *)malloc(das(sizeof(double), 3, d, &err_code));
+            array = daa(sizeof(double), 3, d, st, &err_code, mem_ptr, NULL);
+            sum += (size_t) ((double ***) array)[15][15];
+            free(mem_ptr);
+        }
+        t[1] = now();
+        asize = daa_plan_init(sizeof(double), 3, d, st, NULL, &err_code, &plan);
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            mem_ptr = (char *)malloc(asize);
+            array = daa_plan_build(&plan, &err_code, mem_ptr, NULL);
+            sum += (size_t) ((double ***) array)[15][15];
+            free(mem_ptr);
+        }
+        t[2] = now();
+        daa_plan_free(&plan);
+        sink = (double) sum;
+
+        fprintf(stderr, "das() + daa() ns   daa_plan_build() ns\n");
+        fprintf(stderr, "%16.1f   %19.1f\n\n", (t[1] - t[0]) / NARR * 1e9
+            , (t[2] - t[1]) / NARR * 1e9);
+    }
+
+    /*
+     * BENCH 12
+     */
+    {
+        int err_code = 0;
+        int id;
+        char *mem_ptr;
+        void *array;
+
+        size_t d[3] = {16, 16, 8}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        const size_t NARR = 1000000; /* arrays allocated */
+        daa_pool pool;
+        double t[4];
+        size_t sum = 0;
+
+        fprintf(stderr, "\nBENCH 12");
+        fprintf(stderr, "\n    3 dimensional array of double, 16 KiB of data, 272 pointers");
+        fprintf(stderr, "\n        dimensions: 16, 16, 8");
+        fprintf(stderr, "\n    1M uninitialized temporary arrays, das()/malloc()/daa()/free() vs.");
+        fprintf(stderr, "\n    daa_pool get()/put() vs. daa_pool_cache get()/put(), one thread,");
+        fprintf(stderr, "\n    and daa_pool_cache in 4 threads.  ns per array\n\n");
+
+        id = pool.shape(sizeof(double), 3, d, st, NULL, &err_code);
+
+        t[0] = now();
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            mem_ptr = (char *)malloc(das(sizeof(double), 3, d, &err_code));
+            array = daa(sizeof(double), 3, d, st, &err_code, mem_ptr, NULL);
+            sum += (size_t) ((double ***) array)[15][15];
+            free(mem_ptr);
+        }
+        t[1] = now();
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            array = pool.get(id, &err_code);
+            sum += (size_t) ((double ***) array)[15][15];
+            pool.put(id, array);
+        }
+        t[2] = now();
+        {
+            daa_pool_cache cache(pool);
+
+            for (size_t r=0 ; r<NARR ; r++)
+            {
+                array = cache.get(id, &err_code);
+                sum += (size_t) ((double ***) array)[15][15];
+                cache.put(id, array);
+            }
+        }
+        t[3] = now();
+        sink = (double) sum;
+
+        fprintf(stderr, "das() + daa() ns   daa_pool ns   daa_pool_cache ns   4 threads ns\n");
+        fprintf(stderr, "%16.1f   %11.1f   %17.1f", (t[1] - t[0]) / NARR * 1e9
+            , (t[2] - t[1]) / NARR * 1e9, (t[3] - t[2]) / NARR * 1e9);
+
+        std::vector<std::thread> workers;
+        t[0] = now();
+        for (int w=0 ; w<4 ; w++)
+        {
+            workers.push_back(std::thread([&pool, id, NARR]()
+            {
+                int err = 0;
+                size_t s = 0;
+                void *a;
+                daa_pool_cache cache(pool);
+
+                for (size_t r=0 ; r<NARR ; r++)
+                {
+                    a = cache.get(id, &err);
+                    s += (size_t) ((double ***) a)[15][15];
+                    cache.put(id, a);
+                }
+                sink = (double) s;
+            }));
+        }
+        for (int w=0 ; w<4 ; w++)
+        {
+            workers[w].join();
+        }
+        t[1] = now();
+
+        fprintf(stderr, "   %12.1f\n\n", (t[1] - t[0]) / (4 * NARR) * 1e9);
+    }
+
+    /*
+     * BENCH 13
+     */
+    {
+        int err_code = 0;
+        static char arena_buf[4*1024*1024]; /* the arena */
+        char *base[16];
+        void *array;
+
+        size_t d[4][3] = {{4, 4, 4}, {8, 8, 8}, {16, 8, 4}, {2, 32, 16}}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        const size_t NARR = 1000000; /* arrays allocated */
+        daa_arena arena;
+        double t[4];
+        size_t sum = 0;
+
+        fprintf(stderr, "\nBENCH 13");
+        fprintf(stderr, "\n    3 dimensional arrays of float, 4 shapes, 16 live at a time");
+        fprintf(stderr, "\n        dimensions: 4, 4, 4 and 8, 8, 8 and 16, 8, 4 and 2, 32, 16");
+        fprintf(stderr, "\n    1M uninitialized arrays, das()/malloc()/daa()/free() vs.");
+        fprintf(stderr, "\n    daa_arena_daa()/daa_arena_free() over a 4 MiB static buffer.  ns per");
+        fprintf(stderr, "\n    array\n\n");
+
+        for (int k=0 ; k<16 ; k++)
+        {
+            base[k] = NULL;
+        }
+        t[0] = now();
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            free(base[r % 16]);
+            base[r % 16] = (char *)malloc(das(sizeof(float), 3, d[r % 4], &err_code));
+            array = daa(sizeof(float), 3, d[r % 4], st, &err_code, base[r % 16], NULL);
+            sum += (size_t) ((float ***) array)[1][1];
+        }
+        t[1] = now();
+        for (int k=0 ; k<16 ; k++)
+        {
+            free(base[k]);
+            base[k] = NULL;
+        }
+
+        daa_arena_init(&arena, arena_buf, sizeof(arena_buf));
+        t[2] = now();
+        for (size_t r=0 ; r<NARR ; r++)
+        {
+            daa_arena_free(&arena, base[r % 16]);
+            array = daa_arena_daa(&arena, sizeof(float), 3, d[r % 4], st, NULL, &err_code
+                , NULL, &base[r % 16]);
+            sum += (size_t) ((float ***) array)[1][1];
+        }
+        t[3] = now();
+        sink = (double) sum;
+
+        fprintf(stderr, "das() + malloc() + daa() ns   daa_arena_daa() ns   high water mark\n");
+        fprintf(stderr, "%26.1f   %18.1f   %15lu\n\n", (t[1] - t[0]) / NARR * 1e9
+            , (t[3] - t[2]) / NARR * 1e9, (unsigned long) arena.high);
+    }
+
+    /*
+     * BENCH 14
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        void *array;
+
+        size_t d[3] = {1024, 128, 64}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 0;
+        daa_layout zeroed = {DAA_ZEROED, 0, 0};
+        daa_map map;
+        double t[6];
+        double mib[3];
+
+        fprintf(stderr, "\nBENCH 14");
+        fprintf(stderr, "\n    3 dimensional array of double, zero init");
+        fprintf(stderr, "\n        dimensions: 1024, 128, 64, 64 MiB of data");
+        fprintf(stderr, "\n    startup time and resident MiB of the block after the build,");
+        fprintf(stderr, "\n    malloc()/daa() which writes the zeros, calloc()/daa() with");
+        fprintf(stderr, "\n    DAA_ZEROED and daa_map_huge(), which skip them\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        t[0] = now();
+        mem_ptr = (char *)malloc(asize);
+        array = daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+        t[1] = now();
+        mib[0] = resident_mib(mem_ptr, asize);
+        sink = ((double ***) array)[1][1][1];
+        free(mem_ptr);
+
+        t[2] = now();
+        mem_ptr = (char *)calloc(1, asize);
+        array = daa(sizeof(double), 3, d, st, &zeroed, &err_code, mem_ptr, (char *)&init);
+        t[3] = now();
+        mib[1] = resident_mib(mem_ptr, asize);
+        sink = ((double ***) array)[1][1][1];
+        free(mem_ptr);
+
+        t[4] = now();
+        array = daa_map_huge(sizeof(double), 3, d, st, NULL, &err_code, (char *)&init, &map);
+        t[5] = now();
+        mib[2] = resident_mib(map.base, map.stats.size);
+        sink = ((double ***) array)[1][1][1];
+        daa_unmap(&map);
+
+        fprintf(stderr, "                   build ms   resident MiB\n");
+        fprintf(stderr, "malloc()/daa()    %9.2f   %12.1f\n", (t[1] - t[0]) * 1e3, mib[0]);
+        fprintf(stderr, "calloc()/daa()    %9.2f   %12.1f\n", (t[3] - t[2]) * 1e3, mib[1]);
+        fprintf(stderr, "daa_map_huge()    %9.2f   %12.1f\n\n", (t[5] - t[4]) * 1e3, mib[2]);
+    }
+
+    /*
+     * BENCH 15
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *box_ptr;
+        char *tbl_ptr;
+        double ***array;
+        double ***box;
+        double ***view = NULL;
+
+        size_t d[3] = {128, 128, 128}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        ptrdiff_t lo[3] = {32, 32, 32}; /* the box */
+        size_t n[3] = {64, 64, 64};
+        const int REPS = 200;
+        daa_desc desc;
+        daa_desc vdesc;
+        double t[4];
+        double sum = 0;
+
+        fprintf(stderr, "\nBENCH 15");
+        fprintf(stderr, "\n    3 dimensional array of double, a 64, 64, 64 box of it");
+        fprintf(stderr, "\n        dimensions: 128, 128, 128");
+        fprintf(stderr, "\n    a copy of the box(das()/daa() once, memcpy() of the rows) vs. a");
+        fprintf(stderr, "\n    dad_sub()/daa_sub() view over the data in a table allocated once.");
+        fprintf(stderr, "\n    us per box\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr
+            , (char *)&sum);
+        asize = das(sizeof(double), 3, n, &err_code);
+        box_ptr = (char *)malloc(asize);
+        box = (double ***) daa(sizeof(double), 3, n, st, &err_code, box_ptr, NULL);
+        dad(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+        dad_sub(&desc, lo, n, NULL, st, &err_code, &vdesc);
+        tbl_ptr = (char *)malloc(das_sub(&vdesc, &err_code));
+
+        t[0] = now();
+        for (int r=0 ; r<REPS ; r++)
+        {
+            for (size_t i=0 ; i<64 ; i++)
+            {
+                for (size_t j=0 ; j<64 ; j++)
+                {
+                    memcpy(box[i][j], &array[32 + i][32 + j][32], 64 * sizeof(double));
+                }
+            }
+            sum += box[r % 64][1][1];
+        }
+        t[1] = now();
+
+        t[2] = now();
+        for (int r=0 ; r<REPS ; r++)
+        {
+            lo[0] = r % 64;
+            dad_sub(&desc, lo, n, NULL, st, &err_code, &vdesc);
+            view = (double ***) daa_sub(&vdesc, &err_code, tbl_ptr);
+            sum += view[r % 64][1][1];
+        }
+        t[3] = now();
+        sink = sum;
+
+        fprintf(stderr, "copy us   view us   table bytes   box bytes\n");
+        fprintf(stderr, "%7.1f   %7.1f   %11lu   %9lu\n\n", (t[1] - t[0]) / REPS * 1e6
+            , (t[3] - t[2]) / REPS * 1e6, (unsigned long) das_sub(&vdesc, &err_code)
+            , (unsigned long) (64 * 64 * 64 * sizeof(double)));
+
+        free(tbl_ptr);
+        free(box_ptr);
+        free(mem_ptr);
+    }
+
+    /*
+     * BENCH 16
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *ptr_area;
+        float *frame;
+        float **array = NULL;
+
+        size_t d[2] = {1080, 1920}; /* dimensions */
+        ptrdiff_t st[2] = {0, 0}; /* starting subscripts */
+        const int REPS = 100;
+        double t[4];
+        double sum = 0;
+
+        fprintf(stderr, "\nBENCH 16");
+        fprintf(stderr, "\n    2 dimensional array of float over a received frame");
+        fprintf(stderr, "\n        dimensions: 1080, 1920");
+        fprintf(stderr, "\n    das()/malloc()/daa() and a memcpy() of the frame vs.");
+        fprintf(stderr, "\n    daa_adopt() in a pointer area allocated once.  us per frame\n\n");
+
+        frame = (float *)malloc(d[0] * d[1] * sizeof(float));
+        for (size_t i=0 ; i<d[0] * d[1] ; i++)
+        {
+            frame[i] = (float) (i % 256);
+        }
+
+        asize = das(sizeof(float), 2, d, &err_code);
+        t[0] = now();
+        for (int r=0 ; r<REPS ; r++)
+        {
+            mem_ptr = (char *)malloc(asize);
+            array = (float **) daa(sizeof(float), 2, d, st, &err_code, mem_ptr, NULL);
+            memcpy(&array[0][0], frame, d[0] * d[1] * sizeof(float));
+            sum += array[r][r];
+            free(mem_ptr);
+        }
+        t[1] = now();
+
+        ptr_area = (char *)malloc(das_adopt(sizeof(float), 2, d, NULL, &err_code));
+        t[2] = now();
+        for (int r=0 ; r<REPS ; r++)
+        {
+            array = (float **) daa_adopt(sizeof(float), 2, d, st, NULL, &err_code
+                , (char *)frame, ptr_area);
+            sum += array[r][r];
+        }
+        t[3] = now();
+        sink = sum;
+
+        fprintf(stderr, "copy us   adopt us\n");
+        fprintf(stderr, "%7.1f   %8.2f\n\n", (t[1] - t[0]) / REPS * 1e6
+            , (t[3] - t[2]) / REPS * 1e6);
+
+        free(ptr_area);
+        free(frame);
+    }
+
+    /*
+     * BENCH 17
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        double ***array;
+        FILE *fp;
+
+        size_t d[3] = {256, 256, 128}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1;
+        daa_desc desc;
+        daa_file file;
+        double t[6];
+        double mib[2];
+        double sum = 0;
+
+        fprintf(stderr, "\nBENCH 17");
+        fprintf(stderr, "\n    3 dimensional array of double in a .npy file");
+        fprintf(stderr, "\n        dimensions: 256, 256, 128, 64 MiB of data");
+        fprintf(stderr, "\n    daa_npy_write() of the array, then a load with das()/malloc()/daa()");
+        fprintf(stderr, "\n    and fread() of the data vs. daa_npy_map().  ms and the growth of the");
+        fprintf(stderr, "\n    resident set in MiB, the file in the page cache\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr
+            , (char *)&init);
+        dad(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+        t[0] = now();
+        daa_npy_write("daa_bench.npy", "<f8", &desc, &err_code);
+        t[1] = now();
+        free(mem_ptr);
+
+        mib[0] = rss_mib();
+        t[2] = now();
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, NULL);
+        fp = fopen("daa_bench.npy", "rb");
+        fseek(fp, 128, SEEK_SET); /* the .npy header of this shape */
+        if (fread(&array[0][0][0], sizeof(double), 256 * 256 * 128, fp) != 256 * 256 * 128)
+        {
+            fprintf(stderr, "daa: error on fread().\n");
+        }
+        fclose(fp);
+        t[3] = now();
+        mib[0] = rss_mib() - mib[0];
+        sum += array[255][255][127];
+        free(mem_ptr);
+
+        mib[1] = rss_mib();
+        t[4] = now();
+        array = (double ***) daa_npy_map("daa_bench.npy", NULL, DAA_FILE_READ, &err_code
+            , &file);
+        t[5] = now();
+        mib[1] = rss_mib() - mib[1];
+        sum += array[255][255][127];
+        daa_file_unmap(&file);
+        remove("daa_bench.npy");
+        sink = sum;
+
+        fprintf(stderr, "daa_npy_write() %.1f ms, %.0f MiB/s\n\n", (t[1] - t[0]) * 1e3
+            , 64 / (t[1] - t[0]));
+        fprintf(stderr, "                         load ms   resident MiB added\n");
+        fprintf(stderr, "das()/malloc()/fread()   %7.2f   %18.1f\n", (t[3] - t[2]) * 1e3
+            , mib[0]);
+        fprintf(stderr, "daa_npy_map()            %7.2f   %18.1f\n\n", (t[5] - t[4]) * 1e3
+            , mib[1]);
+    }
+
+    /*
+     * BENCH 18
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        double ***array;
+        FILE *fp;
+
+        size_t d[3] = {256, 256, 256}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 1;
+        daa_head head;
+        double t[8];
+
+        fprintf(stderr, "\nBENCH 18");
+        fprintf(stderr, "\n    3 dimensional array of double saved and loaded");
+        fprintf(stderr, "\n        dimensions: 256, 256, 256, 128 MiB of data");
+        fprintf(stderr, "\n    fwrite()/fread() of each element through the pointers vs.");
+        fprintf(stderr, "\n    daa_save() and das_load()/daa_load(), checksum included.  MiB/s,");
+        fprintf(stderr, "\n    the file in the page cache\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr
+            , (char *)&init);
+
+        t[0] = now();
+        fp = fopen("daa_bench.daa", "wb");
+        for (size_t i=0 ; i<256 ; i++)
+        {
+            for (size_t j=0 ; j<256 ; j++)
+            {
+                for (size_t k=0 ; k<256 ; k++)
+                {
+                    fwrite(&array[i][j][k], sizeof(double), 1, fp);
+                }
+            }
+        }
+        fclose(fp);
+        t[1] = now();
+        fp = fopen("daa_bench.daa", "rb");
+        for (size_t i=0 ; i<256 ; i++)
+        {
+            for (size_t j=0 ; j<256 ; j++)
+            {
+                for (size_t k=0 ; k<256 ; k++)
+                {
+                    if (fread(&array[i][j][k], sizeof(double), 1, fp) != 1)
+                    {
+                        fprintf(stderr, "daa: error on fread().\n");
+                    }
+                }
+            }
+        }
+        fclose(fp);
+        t[2] = now();
+        free(mem_ptr);
+
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr
+            , (char *)&init);
+        t[3] = now();
+        daa_save("daa_bench.daa", sizeof(double), 3, d, st, NULL, &err_code, mem_ptr);
+        t[4] = now();
+        free(mem_ptr);
+
+        t[5] = now();
+        mem_ptr = (char *)malloc(das_load("daa_bench.daa", &head, &err_code));
+        array = (double ***) daa_load("daa_bench.daa", &head, &err_code, mem_ptr);
+        t[6] = now();
+        sink = array[255][255][255];
+        free(mem_ptr);
+        remove("daa_bench.daa");
+
+        fprintf(stderr, "                     save MiB/s   load MiB/s\n");
+        fprintf(stderr, "element fwrite/fread  %10.0f   %10.0f\n", 128 / (t[1] - t[0])
+            , 128 / (t[2] - t[1]));
+        fprintf(stderr, "daa_save/daa_load     %10.0f   %10.0f\n\n", 128 / (t[4] - t[3])
+            , 128 / (t[6] - t[5]));
+    }
+
+    /*
+     * BENCH 19
+     */
+    {
+        int err_code = 0;
+        char *buf;
+        float ***slab;
+        int fd;
+
+        size_t d[3] = {512, 256, 256}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        const size_t ROW = 256 * 256 * sizeof(float); /* bytes of one element of dimension 0 */
+        daa_slabs slabs;
+        double t[4];
+        double mib[2];
+        double peak;
+        double sum = 0;
+
+        fprintf(stderr, "\nBENCH 19");
+        fprintf(stderr, "\n    3 dimensional array of float out of core, 128 MiB file");
+        fprintf(stderr, "\n        dimensions: 512, 256, 256");
+        fprintf(stderr, "\n    a sweep of the file with read() into an 8 MiB buffer vs. a sweep of");
+        fprintf(stderr, "\n    daa_slabs_get() slabs of 32 elements(8 MiB), at most 4 resident.");
+        fprintf(stderr, "\n    MiB/s and the largest growth of the resident set in MiB\n\n");
+
+        buf = (char *)malloc(32 * ROW);
+        memset(buf, 0, 32 * ROW);
+        fd = open("daa_bench.raw", O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        for (int k=0 ; k<16 ; k++)
+        {
+            if (write(fd, buf, 32 * ROW) != (ssize_t) (32 * ROW))
+            {
+                fprintf(stderr, "daa: error on write().\n");
+            }
+        }
+        close(fd);
+
+        free(buf);
+
+        mib[0] = rss_mib();
+        t[0] = now();
+        buf = (char *)malloc(32 * ROW);
+        fd = open("daa_bench.raw", O_RDONLY);
+        while (read(fd, buf, 32 * ROW) > 0)
+        {
+            sum += buf[ROW];
+        }
+        close(fd);
+        t[1] = now();
+        mib[0] = rss_mib() - mib[0];
+        free(buf);
+
+        mib[1] = rss_mib();
+        peak = 0;
+        t[2] = now();
+        daa_slabs_open("daa_bench.raw", 0, sizeof(float), 3, d, st, 32, 4, DAA_FILE_READ
+            , &err_code, &slabs);
+        for (ptrdiff_t i=0 ; i<512 ; i++)
+        {
+            slab = (float ***) daa_slabs_get(&slabs, i, &err_code);
+            for (size_t j=0 ; j<256 ; j++)
+            {
+                sum += slab[i][j][0];
+            }
+            if (i % 32 == 31 && rss_mib() - mib[1] > peak)
+            {
+                peak = rss_mib() - mib[1];
+            }
+        }
+        daa_slabs_close(&slabs);
+        t[3] = now();
+        sink = sum;
+        remove("daa_bench.raw");
+
+        fprintf(stderr, "                        MiB/s   resident MiB added\n");
+        fprintf(stderr, "read() sweep         %7.0f   %18.1f\n", 128 / (t[1] - t[0]), mib[0]);
+        fprintf(stderr, "daa_slabs_get() sweep%7.0f   %18.1f\n\n", 128 / (t[3] - t[2]), peak);
+    }
+
+
+    /*
+     * BENCH 20
+     */
+    {
+        int err_code = 0;
+        char *mem_ptr;
+        float ***array;
+
+        size_t d[3] = {1024, 256, 128}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        daa_dirty dirty = {};
+        double t[3];
+        pid_t pid;
+        size_t i;
+
+        fprintf(stderr, "\nBENCH 20");
+        fprintf(stderr, "\n    3 dimensional array of float checkpoints, 128 MiB");
+        fprintf(stderr, "\n        dimensions: 1024, 256, 128");
+        fprintf(stderr, "\n    daa_save() vs. the two full daa_checkpoint()s of a tracker, one to");
+        fprintf(stderr, "\n    each file, vs. one after changing an element in 1%% of the innermost");
+        fprintf(stderr, "\n    rows, tracked by innermost row.  ms the caller is stopped, ms to the");
+        fprintf(stderr, "\n    checkpoint written and MiB written.  daa_checkpoint() syncs the");
+        fprintf(stderr, "\n    file, daa_save() does not\n\n");
+
+        mem_ptr = (char *)daa_alloc(das(sizeof(float), 3, d, &err_code), 64);
+        array = (float ***) daa(sizeof(float), 3, d, st, &err_code, mem_ptr, NULL);
+        daa_dirty_init(sizeof(float), 3, d, NULL, &err_code, mem_ptr, 1, &dirty);
+        for (i=0 ; i<1024 ; i++)
+        {
+            memset(array[i][0], (int) i, 256 * 128 * sizeof(float));
+        }
+
+        fprintf(stderr, "                          stopped ms   written ms   MiB written\n");
+        t[0] = now();
+        daa_save("daa_bench.ckpt", sizeof(float), 3, d, st, NULL, &err_code, mem_ptr);
+        t[1] = now();
+        fprintf(stderr, "daa_save()                %10.1f   %10.1f   %11.1f\n"
+            , 1000 * (t[1] - t[0]), 1000 * (t[1] - t[0]), 128.0);
+
+        for (int c=0 ; c<3 ; c++)
+        {
+            if (c == 2)
+            {
+                for (i=0 ; i<1024*256/100 ; i++)
+                {
+                    size_t r = (i * 2654435761UL) % (1024 * 256);
+
+                    array[r / 256][r % 256][r % 128] += 1;
+                    daa_dirty_set(&dirty, &array[r / 256][r % 256][r % 128], sizeof(float));
+                }
+            }
+            t[0] = now();
+            pid = daa_checkpoint("daa_bench.ckpt", sizeof(float), 3, d, st, NULL, &err_code
+                , mem_ptr, &dirty);
+            t[1] = now();
+            if (pid < 0 || daa_checkpoint_wait(pid, &dirty, &err_code) != 0)
+            {
+                fprintf(stderr, "daa: error on daa_checkpoint(). %s\n", daa_errs[err_code]);
+            }
+            t[2] = now();
+            fprintf(stderr, "daa_checkpoint() %s  %10.1f   %10.1f   %11.1f\n"
+                , c < 2 ? "full   " : "1% rows", 1000 * (t[1] - t[0]), 1000 * (t[2] - t[0])
+                , dirty.written / (1024.0 * 1024.0));
+        }
+        fprintf(stderr, "\n");
+
+        remove("daa_bench.ckpt");
+        remove("daa_bench.ckpt.0");
+        remove("daa_bench.ckpt.1");
+        daa_dirty_free(&dirty);
+        daa_free(mem_ptr);
+    }
+}
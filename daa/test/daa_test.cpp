@@ -12,8 +12,16 @@
 
 #include <cstdio>
 #include <cstring>
+#include <utility>
+
+#include <sys/resource.h>
 
 #include "daa.hpp"
+#include "daa_thread.hpp"
+#include "daa_array.hpp"
+#include "daa_mmap.hpp"
+#include "daa_file.hpp"
+#include "daa_pool.hpp"
 
 /*
  * test code for das()/daa().  all the tests are completely independent,
@@ -1089,5 +1097,1853 @@ main()
             fprintf(stderr, "err_code = %d\n\n", err_code);
         }
     }
+
+    /*
+     * TEST 19
+     */
+    {
+        int err_code = 0;
+        int isize = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        unsigned int d_int[4] = {4, 1024, 1024, 1024}; /* dimensions(int version) */
+        size_t d_big[4] = {4, 1024, 1024, 1024}; /* dimensions */
+        size_t d_ovf[4] = {65536, 65536, 65536, 65536}; /* dimensions */
+        size_t d[3] = {2, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {-1, 0, 100}; /* starting subscripts */
+        double init = 0.5;
+        double ***array = NULL; /* array pointer */
+
+        fprintf(stderr, "\nTEST 19");
+        fprintf(stderr, "\n    size_t versions of das()/daa()");
+        fprintf(stderr, "\n        das() of a 4, 1024, 1024, 1024 double array(32 GiB)");
+        fprintf(stderr, "\n            with the int and size_t versions");
+        fprintf(stderr, "\n        das() of a 65536, 65536, 65536, 65536 double array");
+        fprintf(stderr, "\n            that overflows size_t");
+        fprintf(stderr, "\n    3 dimensional array of double");
+        fprintf(stderr, "\n        dimensions: 2, 3, 4");
+        fprintf(stderr, "\n        starting subscripts: -1, 0, 100");
+        fprintf(stderr, "\n        init: 0.5\n");
+        fprintf(stderr, "\n    set array[0][2][103] = 7.0\n\n");
+
+        isize = das(sizeof(double), 4, d_int, &err_code);
+        fprintf(stderr, "int das() = %d, %s\n", isize, daa_errs[err_code]);
+
+        err_code = 0;
+        asize = das(sizeof(double), 4, d_big, &err_code);
+        fprintf(stderr, "size_t das() = %lu\n", (unsigned long) asize);
+
+        asize = das(sizeof(double), 4, d_ovf, &err_code);
+        fprintf(stderr, "size_t das() = %lu, %s\n\n", (unsigned long) asize
+            , daa_errs[err_code]);
+
+        err_code = 0;
+        asize = das(sizeof(double), 3, d, &err_code);
+
+        mem_ptr = (char *)malloc(asize);
+
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[0][2][103] = 7.0;
+
+            fprintf(stderr, "sizeof(double) = %ld\n", sizeof(double));
+            fprintf(stderr, "array size = %lu\n\n", (unsigned long) asize);
+            for (ptrdiff_t i=st[0] ; i<st[0]+ptrdiff_t(d[0]) ; i++)
+            {
+                for (ptrdiff_t j=st[1] ; j<st[1]+ptrdiff_t(d[1]) ; j++)
+                {
+                    for (ptrdiff_t k=st[2] ; k<st[2]+ptrdiff_t(d[2]) ; k++)
+                    {
+                        fprintf(stderr, "array[%2ld][%2ld][%3ld] = %5.1f\n"
+                            , (long) i, (long) j, (long) k, array[i][j][k]);
+                    }
+                }
+            }
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+            free(mem_ptr);
+        }
+    }
+
+    /*
+     * TEST 20
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *serial_ptr;
+
+        size_t d[4] = {3, 50, 40, 20}; /* dimensions */
+        ptrdiff_t st[4] = {-1, 0, 1, 2}; /* starting subscripts */
+        double init = 2.5;
+        double ****array = NULL; /* array pointer */
+        unsigned int nthreads[4] = {1, 2, 7, 64}; /* thread counts */
+
+        fprintf(stderr, "\nTEST 20");
+        fprintf(stderr, "\n    4 dimensional array of double, daa_parallel()");
+        fprintf(stderr, "\n        dimensions: 3, 50, 40, 20");
+        fprintf(stderr, "\n        starting subscripts: -1, 0, 1, 2");
+        fprintf(stderr, "\n        init: 2.5\n");
+        fprintf(stderr, "\n    build the array with daa() and with daa_parallel() using");
+        fprintf(stderr, "\n    1, 2, 7 and 64 threads in the same space and compare the bytes.");
+        fprintf(stderr, "\n    set array[1][49][40][21] = 9.0\n\n");
+
+        asize = das(sizeof(double), 4, d, &err_code);
+
+        mem_ptr = (char *)malloc(asize);
+        serial_ptr = (char *)malloc(asize);
+
+        memset(mem_ptr, 0, asize);
+        daa(sizeof(double), 4, d, st, &err_code, mem_ptr, (char *)&init);
+        memcpy(serial_ptr, mem_ptr, asize);
+
+        for (int t=0 ; t<4 ; t++)
+        {
+            memset(mem_ptr, 0, asize);
+            array = (double ****) daa_parallel(sizeof(double), 4, d, st, &err_code
+                , mem_ptr, (char *)&init, nthreads[t]);
+
+            fprintf(stderr, "threads = %2u, bytes identical to daa() = %s\n", nthreads[t]
+                , memcmp(mem_ptr, serial_ptr, asize) == 0 ? "yes" : "no");
+        }
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[1][49][40][21] = 9.0;
+
+            fprintf(stderr, "\nsizeof(double) = %ld\n", sizeof(double));
+            fprintf(stderr, "array size = %lu\n\n", (unsigned long) asize);
+            fprintf(stderr, "array[-1][ 0][ 1][ 2] = %5.1f\n", array[-1][0][1][2]);
+            fprintf(stderr, "array[ 1][49][40][21] = %5.1f\n", array[1][49][40][21]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(serial_ptr);
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 21
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *serial_ptr;
+
+        size_t d[3] = {10, 30, 40}; /* dimensions */
+        ptrdiff_t st[3] = {1, 1, 1}; /* starting subscripts */
+        int init = 7;
+        int ***array = NULL; /* array pointer */
+        unsigned int nworkers = 4; /* worker threads */
+        int cpus[4] = {0, 0, 0, 0}; /* cpu of each worker */
+
+        fprintf(stderr, "\nTEST 21");
+        fprintf(stderr, "\n    3 dimensional array of int, daa_place()");
+        fprintf(stderr, "\n        dimensions: 10, 30, 40");
+        fprintf(stderr, "\n        starting subscripts: 1, 1, 1");
+        fprintf(stderr, "\n        init: 7\n");
+        fprintf(stderr, "\n    place the array in 4 slabs of the first dimension, each built");
+        fprintf(stderr, "\n    by a worker pinned to cpu 0, and compare the bytes to daa().");
+        fprintf(stderr, "\n    each worker sets the first element of its slab to the worker number.\n\n");
+
+        asize = das(sizeof(int), 3, d, &err_code);
+
+        mem_ptr = (char *)malloc(asize);
+        serial_ptr = (char *)malloc(asize);
+
+        memset(mem_ptr, 0, asize);
+        daa(sizeof(int), 3, d, st, &err_code, mem_ptr, (char *)&init);
+        memcpy(serial_ptr, mem_ptr, asize);
+
+        memset(mem_ptr, 0, asize);
+        array = (int ***) daa_place(sizeof(int), 3, d, st, &err_code, mem_ptr, (char *)&init
+            , nworkers, cpus, NULL);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            fprintf(stderr, "bytes identical to daa() = %s\n\n"
+                , memcmp(mem_ptr, serial_ptr, asize) == 0 ? "yes" : "no");
+
+            for (unsigned int w=0 ; w<nworkers ; w++)
+            {
+                size_t u0, u1;
+
+                daa_slab(d[0], nworkers, w, &u0, &u1);
+                array[st[0]+u0][1][1] = w;
+                fprintf(stderr, "worker %u slab array[%2ld..%2ld], array[%2ld][1][1] = %d\n", w
+                    , (long) (st[0]+u0), (long) (st[0]+u1-1), (long) (st[0]+u0)
+                    , array[st[0]+u0][1][1]);
+            }
+
+            fprintf(stderr, "\nsizeof(int) = %ld\n", sizeof(int));
+            fprintf(stderr, "array size = %lu\n\n", (unsigned long) asize);
+            fprintf(stderr, "array[10][30][40] = %d\n", array[10][30][40]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(serial_ptr);
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 22
+     */
+    {
+        int err_code = 0;
+
+        size_t d[4] = {3, 5, 4, 2}; /* dimensions */
+        ptrdiff_t st[4] = {-1, -5, 10, 0}; /* starting subscripts */
+        double init = 0.;
+
+        fprintf(stderr, "\nTEST 22");
+        fprintf(stderr, "\n    4 dimensional daa_array<double, 4>");
+        fprintf(stderr, "\n        dimensions: 3, 5, 4, 2");
+        fprintf(stderr, "\n        starting subscripts: -1, -5, 10, 0");
+        fprintf(stderr, "\n        init: 0\n");
+        fprintf(stderr, "\n    set elements with at() to the sum of the subscripts, pass the");
+        fprintf(stderr, "\n    slice array[-1] to f1() as in TEST 1, move the array to a second");
+        fprintf(stderr, "\n    daa_array and print it from there.  the block is freed by the");
+        fprintf(stderr, "\n    destructor.\n\n");
+
+        daa_array<double, 4> array(d, st, &init, &err_code);
+
+        if (!array)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (ptrdiff_t i=st[0] ; i<st[0]+ptrdiff_t(d[0]) ; i++)
+            {
+                for (ptrdiff_t j=st[1] ; j<st[1]+ptrdiff_t(d[1]) ; j++)
+                {
+                    for (ptrdiff_t k=st[2] ; k<st[2]+ptrdiff_t(d[2]) ; k++)
+                    {
+                        for (ptrdiff_t l=st[3] ; l<st[3]+ptrdiff_t(d[3]) ; l++)
+                        {
+                            array.at(i, j, k, l) = double(i + j + k + l);
+                        }
+                    }
+                }
+            }
+
+            f1(array[-1]);
+
+            daa_array<double, 4> moved(std::move(array));
+
+            fprintf(stderr, "sizeof(double) = %ld\n", sizeof(double));
+            fprintf(stderr, "array size = %lu\n", (unsigned long) moved.size());
+            fprintf(stderr, "moved from array is empty = %s\n\n", array ? "no" : "yes");
+            for (ptrdiff_t i=st[0] ; i<st[0]+ptrdiff_t(d[0]) ; i++)
+            {
+                for (ptrdiff_t j=st[1] ; j<st[1]+ptrdiff_t(d[1]) ; j++)
+                {
+                    fprintf(stderr, "array[%2ld][%2ld][10][0] = %5.2f"
+                        "    array[%2ld][%2ld][13][1] = %5.2f\n"
+                        , (long) i, (long) j, moved[i][j][10][0]
+                        , (long) i, (long) j, moved.at(i, j, 13, 1));
+                }
+            }
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+
+            size_t hd[3] = {((size_t) -1) / sizeof(char *) + 1, 1, 1};
+            ptrdiff_t hst[3] = {0, 0, 0};
+            daa_array<char, 3> huge(hd, hst, NULL, &err_code);
+
+            fprintf(stderr, "daa_array<char, 3> with more pointers than fit in size_t: %s\n\n"
+                , huge ? "no error" : daa_errs[err_code]);
+        }
+    }
+
+    /*
+     * TEST 23
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0, nsize = 0;
+        char *mem_ptr;
+        char *data_ptr;
+
+        size_t d[3] = {4, 5, 6}; /* dimensions */
+        ptrdiff_t st[3] = {-2, 1, 3}; /* starting subscripts */
+        double init = 1.5;
+        double ***array; /* array pointer */
+        daa_layout layout = {DAA_NO_PTRS};
+        daa_desc desc;
+        int same = 1;
+
+        fprintf(stderr, "\nTEST 23");
+        fprintf(stderr, "\n    3 dimensional array of double, dad() descriptor");
+        fprintf(stderr, "\n        dimensions: 4, 5, 6");
+        fprintf(stderr, "\n        starting subscripts: -2, 1, 3");
+        fprintf(stderr, "\n        init: 1.5\n");
+        fprintf(stderr, "\n    compare the address of every element through the daa() pointer");
+        fprintf(stderr, "\n    and daa_at().  then build the array with DAA_NO_PTRS, no pointer");
+        fprintf(stderr, "\n    arrays, and set array[1][5][8] = 7.0 through daa_at()\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, (char *)&init);
+        dad(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+
+        for (ptrdiff_t i=-2 ; i<=1 ; i++)
+        {
+            for (ptrdiff_t j=1 ; j<=5 ; j++)
+            {
+                for (ptrdiff_t k=3 ; k<=8 ; k++)
+                {
+                    ptrdiff_t idx[3] = {i, j, k};
+
+                    if ((char *) &array[i][j][k] != daa_at(&desc, idx))
+                    {
+                        same = 0;
+                    }
+                }
+            }
+        }
+        fprintf(stderr, "all addresses identical = %s\n", same ? "yes" : "no");
+        free(mem_ptr);
+
+        nsize = das(sizeof(double), 3, d, &layout, &err_code);
+        mem_ptr = (char *)malloc(nsize);
+        data_ptr = (char *) daa(sizeof(double), 3, d, st, &layout, &err_code, mem_ptr
+            , (char *)&init);
+
+        if (data_ptr == NULL || dad(sizeof(double), 3, d, st, &layout, &err_code, mem_ptr
+            , &desc) == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            ptrdiff_t first[3] = {-2, 1, 3};
+            ptrdiff_t last[3] = {1, 5, 8};
+
+            *(double *) daa_at(&desc, last) = 7.0;
+
+            fprintf(stderr, "\narray size = %lu, DAA_NO_PTRS size = %lu\n", (unsigned long) asize
+                , (unsigned long) nsize);
+            fprintf(stderr, "data_ptr == mem_ptr = %s\n\n", data_ptr == mem_ptr ? "yes" : "no");
+            fprintf(stderr, "array[-2][1][3] = %5.1f\n", *(double *) daa_at(&desc, first));
+            fprintf(stderr, "array[ 1][5][8] = %5.1f\n", *(double *) daa_at(&desc, last));
+            fprintf(stderr, "last data element = %5.1f\n", ((double *) mem_ptr)[4*5*6 - 1]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 24
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0, osize = 0;
+        char *mem_ptr;
+        char *off_ptr;
+
+        size_t d[4] = {3, 5, 4, 2}; /* dimensions */
+        ptrdiff_t st[4] = {1, -1, 0, 2}; /* starting subscripts */
+        double init = 3.5;
+        double ****array; /* array pointer */
+        void *off_array; /* DAA_OFF32 array */
+        daa_layout layout = {DAA_OFF32};
+        daa_stats stats[2];
+        int same = 1;
+
+        fprintf(stderr, "\nTEST 24");
+        fprintf(stderr, "\n    4 dimensional array of double, DAA_OFF32 offset tables");
+        fprintf(stderr, "\n        dimensions: 3, 5, 4, 2");
+        fprintf(stderr, "\n        starting subscripts: 1, -1, 0, 2");
+        fprintf(stderr, "\n        init: 3.5\n");
+        fprintf(stderr, "\n    print the das() stats of the pointer and offset table layouts.");
+        fprintf(stderr, "\n    compare the offset from the block base of every element through");
+        fprintf(stderr, "\n    the daa() pointers and daa_off().  set array[3][3][3][3] = 4.0\n\n");
+
+        asize = das(sizeof(double), 4, d, NULL, &stats[0], &err_code);
+        osize = das(sizeof(double), 4, d, &layout, &stats[1], &err_code);
+
+        fprintf(stderr, "layout     data   tables   pad   size   overhead\n");
+        for (int m=0 ; m<2 ; m++)
+        {
+            fprintf(stderr, "%-7s   %5lu   %6lu   %3lu   %4lu   %8lu\n", m ? "OFF32" : "pointer"
+                , (unsigned long) stats[m].data_bytes, (unsigned long) stats[m].ptr_bytes
+                , (unsigned long) stats[m].pad_bytes, (unsigned long) stats[m].size
+                , (unsigned long) (stats[m].size - stats[m].data_bytes));
+        }
+
+        mem_ptr = (char *)malloc(asize);
+        off_ptr = (char *)malloc(osize);
+        array = (double ****) daa(sizeof(double), 4, d, st, &err_code, mem_ptr, (char *)&init);
+        off_array = daa(sizeof(double), 4, d, st, &layout, &err_code, off_ptr, (char *)&init);
+
+        if (array == NULL || off_array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            ptrdiff_t idx[4];
+
+            for (idx[0]=1 ; idx[0]<=3 ; idx[0]++)
+            {
+                for (idx[1]=-1 ; idx[1]<=3 ; idx[1]++)
+                {
+                    for (idx[2]=0 ; idx[2]<=3 ; idx[2]++)
+                    {
+                        for (idx[3]=2 ; idx[3]<=3 ; idx[3]++)
+                        {
+                            if ((char *) &array[idx[0]][idx[1]][idx[2]][idx[3]] - mem_ptr
+                                != daa_off(off_ptr, off_array, 4, sizeof(double), idx) - off_ptr)
+                            {
+                                same = 0;
+                            }
+                        }
+                    }
+                }
+            }
+            idx[0] = idx[1] = idx[2] = idx[3] = 3;
+            *(double *) daa_off(off_ptr, off_array, 4, sizeof(double), idx) = 4.0;
+
+            fprintf(stderr, "\nall element offsets identical = %s\n\n", same ? "yes" : "no");
+            fprintf(stderr, "array[3][3][3][3] = %5.1f\n"
+                , *(double *) daa_off(off_ptr, off_array, 4, sizeof(double), idx));
+            fprintf(stderr, "last data element = %5.1f\n", ((double *) off_ptr)[3*5*4*2 - 1]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(off_ptr);
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 25
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {2, 5, 7}; /* dimensions */
+        ptrdiff_t st[3] = {0, 1, -3}; /* starting subscripts */
+        float init = 0.5;
+        float ***array; /* array pointer */
+        daa_layout layout = {DAA_PAD_ROWS, 64};
+        daa_stats stats;
+        daa_desc desc;
+        int aligned = 1, same = 1;
+
+        fprintf(stderr, "\nTEST 25");
+        fprintf(stderr, "\n    3 dimensional array of float, 64 byte aligned padded rows");
+        fprintf(stderr, "\n        dimensions: 2, 5, 7");
+        fprintf(stderr, "\n        starting subscripts: 0, 1, -3");
+        fprintf(stderr, "\n        init: 0.5\n");
+        fprintf(stderr, "\n    build the array at an odd address of a daa_alloc() block, check");
+        fprintf(stderr, "\n    that every row is 64 byte aligned and that dad() gives the same");
+        fprintf(stderr, "\n    element addresses.  set array[1][5][3] = 8.0\n\n");
+
+        asize = das(sizeof(float), 3, d, &layout, &stats, &err_code);
+        mem_ptr = (char *)daa_alloc(asize + 1, 64);
+        array = (float ***) daa(sizeof(float), 3, d, st, &layout, &err_code, mem_ptr + 1
+            , (char *)&init);
+
+        if (array == NULL || dad(sizeof(float), 3, d, st, &layout, &err_code, mem_ptr + 1
+            , &desc) == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (ptrdiff_t i=0 ; i<=1 ; i++)
+            {
+                for (ptrdiff_t j=1 ; j<=5 ; j++)
+                {
+                    if ((size_t) &array[i][j][-3] % 64 != 0)
+                    {
+                        aligned = 0;
+                    }
+                    for (ptrdiff_t k=-3 ; k<=3 ; k++)
+                    {
+                        ptrdiff_t idx[3] = {i, j, k};
+
+                        if ((char *) &array[i][j][k] != daa_at(&desc, idx))
+                        {
+                            same = 0;
+                        }
+                    }
+                }
+            }
+            array[1][5][3] = 8.0;
+
+            fprintf(stderr, "array size = %lu, data = %lu, pointers = %lu, padding = %lu\n"
+                , (unsigned long) stats.size, (unsigned long) stats.data_bytes
+                , (unsigned long) stats.ptr_bytes, (unsigned long) stats.pad_bytes);
+            fprintf(stderr, "row pitch = %ld\n", (long) desc.stride[1]);
+            fprintf(stderr, "all rows 64 byte aligned = %s\n", aligned ? "yes" : "no");
+            fprintf(stderr, "all addresses identical = %s\n\n", same ? "yes" : "no");
+            fprintf(stderr, "array[0][1][-3] = %5.1f\n", array[0][1][-3]);
+            fprintf(stderr, "array[1][5][ 3] = %5.1f\n", array[1][5][3]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        daa_free(mem_ptr);
+    }
+
+    /*
+     * TEST 26
+     */
+    {
+        int err_code = 0;
+
+        size_t d[3] = {16, 256, 256}; /* dimensions */
+        ptrdiff_t st[3] = {1, 0, -2}; /* starting subscripts */
+        int init = 6;
+        int ***array; /* array pointer */
+        daa_map map;
+        const char *kind[4] = {"unknown", "MAP_HUGETLB", "MADV_HUGEPAGE", "normal"};
+
+        fprintf(stderr, "\nTEST 26");
+        fprintf(stderr, "\n    3 dimensional array of int, daa_map_huge() huge page space");
+        fprintf(stderr, "\n        dimensions: 16, 256, 256");
+        fprintf(stderr, "\n        starting subscripts: 1, 0, -2");
+        fprintf(stderr, "\n        init: 6\n");
+        fprintf(stderr, "\n    map the array in huge pages, or normal pages if there are none,");
+        fprintf(stderr, "\n    and print the kind of page obtained.  set array[16][255][253] = 7\n\n");
+
+        array = (int ***) daa_map_huge(sizeof(int), 3, d, st, NULL, &err_code, (char *)&init
+            , &map);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[16][255][253] = 7;
+
+            fprintf(stderr, "page kind = %s\n", kind[map.stats.page_kind]);
+            fprintf(stderr, "array size = %lu, mapping size = %lu\n"
+                , (unsigned long) map.stats.size, (unsigned long) map.map_size);
+            fprintf(stderr, "block huge page aligned = %s\n\n"
+                , (size_t) map.base % HUGE_PAGE == 0 ? "yes" : "no");
+            fprintf(stderr, "array[ 1][  0][ -2] = %d\n", array[1][0][-2]);
+            fprintf(stderr, "array[16][255][253] = %d\n", array[16][255][253]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        daa_unmap(&map);
+    }
+
+    /*
+     * TEST 27
+     */
+    {
+        int err_code = 0;
+        char name[64];
+
+        size_t d[3] = {4, 6, 8}; /* dimensions */
+        ptrdiff_t st[3] = {-1, 2, 0}; /* starting subscripts */
+        double init = 1.25;
+        daa_layout layout = {DAA_REL, 0};
+        daa_map map[2];
+        daa_view view;
+        void *array;
+
+        fprintf(stderr, "\nTEST 27");
+        fprintf(stderr, "\n    3 dimensional array of double, DAA_REL layout in shared memory");
+        fprintf(stderr, "\n        dimensions: 4, 6, 8");
+        fprintf(stderr, "\n        starting subscripts: -1, 2, 0");
+        fprintf(stderr, "\n        init: 1.25\n");
+        fprintf(stderr, "\n    build the array in a POSIX shared memory object, map the object a");
+        fprintf(stderr, "\n    second time at another address and attach a daa_typed_view to it.");
+        fprintf(stderr, "\n    set array[2][7][7] = 5.0 through the second mapping and read it");
+        fprintf(stderr, "\n    through the first\n\n");
+
+        snprintf(name, sizeof(name), "/daa_test_27_%ld", (long) getpid());
+        array = daa_shm_create(name, sizeof(double), 3, d, st, &layout, &err_code
+            , (char *)&init, &map[0]);
+
+        if (array == NULL || daa_shm_attach(name, sizeof(double), 3, d, st, &layout
+            , &err_code, &map[1], &view) == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            daa_typed_view<double, 3> shared(map[1].base, d, st, layout, &err_code);
+            daa_view first;
+            ptrdiff_t idx[3] = {2, 7, 7};
+
+            shared.at(2, 7, 7) = 5.0;
+            daa_attach(sizeof(double), 3, d, st, &layout, &err_code, map[0].base, &first);
+
+            fprintf(stderr, "mappings at different addresses = %s\n"
+                , map[0].base != map[1].base ? "yes" : "no");
+            fprintf(stderr, "view and typed view agree = %s\n\n"
+                , daa_view_at(&view, idx) == (char *) &shared.at(2, 7, 7) ? "yes" : "no");
+            fprintf(stderr, "second mapping array[-1][2][0] = %5.2f\n", shared.at(-1, 2, 0));
+            fprintf(stderr, "second mapping array[ 2][7][7] = %5.2f\n", shared.at(2, 7, 7));
+            fprintf(stderr, "first mapping  array[ 2][7][7] = %5.2f\n"
+                , *(double *) daa_view_at(&first, idx));
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        daa_unmap(&map[1]);
+        daa_unmap(&map[0]);
+        shm_unlink(name);
+    }
+
+    /*
+     * TEST 28
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *clone_ptr;
+
+        size_t d[4] = {3, 4, 5, 6}; /* dimensions */
+        ptrdiff_t st[4] = {0, -2, 1, -1}; /* starting subscripts */
+        short init = 12;
+        short ****array; /* array pointer */
+        short ****clone; /* daa_clone() array pointer */
+
+        fprintf(stderr, "\nTEST 28");
+        fprintf(stderr, "\n    4 dimensional array of short, daa_clone() and daa_rebase()");
+        fprintf(stderr, "\n        dimensions: 3, 4, 5, 6");
+        fprintf(stderr, "\n        starting subscripts: 0, -2, 1, -1");
+        fprintf(stderr, "\n        init: 12\n");
+        fprintf(stderr, "\n    clone the array, set clone[2][1][5][4] = 13 and check the original");
+        fprintf(stderr, "\n    is unchanged.  then realloc() the original to twice its size and");
+        fprintf(stderr, "\n    rebase it to wherever realloc() put it\n\n");
+
+        asize = das(sizeof(short), 4, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        clone_ptr = (char *)malloc(asize);
+        daa(sizeof(short), 4, d, st, &err_code, mem_ptr, (char *)&init);
+        clone = (short ****) daa_clone(sizeof(short), 4, d, st, NULL, &err_code, mem_ptr
+            , clone_ptr);
+
+        if (clone == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            size_t old_addr = (size_t) mem_ptr;
+
+            clone[2][1][5][4] = 13;
+
+            /* the old address is only used for its value */
+            mem_ptr = (char *)realloc(mem_ptr, 2 * asize);
+            array = (short ****) daa_rebase(sizeof(short), 4, d, st, NULL, &err_code
+                , (char *) old_addr, mem_ptr);
+
+            fprintf(stderr, "clone pointers in the clone = %s\n"
+                , (char *) &clone[2][1][5][4] > clone_ptr
+                && (char *) &clone[2][1][5][4] < clone_ptr + asize ? "yes" : "no");
+            fprintf(stderr, "rebased pointers in the new space = %s\n\n"
+                , (char *) &array[2][1][5][4] > mem_ptr
+                && (char *) &array[2][1][5][4] < mem_ptr + asize ? "yes" : "no");
+            fprintf(stderr, "clone[ 2][ 1][ 5][ 4] = %d\n", clone[2][1][5][4]);
+            fprintf(stderr, "array[ 2][ 1][ 5][ 4] = %d\n", array[2][1][5][4]);
+            fprintf(stderr, "array[ 0][-2][ 1][-1] = %d\n", array[0][-2][1][-1]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(clone_ptr);
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 29
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {2, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {1, -1, 0}; /* starting subscripts */
+        long init = 3;
+        long init2 = 4;
+        long ***array; /* array pointer */
+        daa_layout layout = {0, 0, 4};
+        daa_map map;
+
+        fprintf(stderr, "\nTEST 29");
+        fprintf(stderr, "\n    3 dimensional array of long, dimension 0 capacity 4, daa_grow() and");
+        fprintf(stderr, "\n    daa_map_resize()");
+        fprintf(stderr, "\n        dimensions: 2, 3, 4");
+        fprintf(stderr, "\n        starting subscripts: 1, -1, 0");
+        fprintf(stderr, "\n        init: 3, new elements 4\n");
+        fprintf(stderr, "\n    set array[2][1][3] = 5, grow dimension 0 to 4 in place with daa_grow(),");
+        fprintf(stderr, "\n    then map the array and grow it to 9 with daa_map_resize(), beyond the");
+        fprintf(stderr, "\n    capacity.  then shrink a mapping with no capacity in place, and grow a");
+        fprintf(stderr, "\n    DAA_REL array aligned to 65536, more than mremap() keeps\n\n");
+
+        asize = das(sizeof(long), 3, d, &layout, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (long ***) daa(sizeof(long), 3, d, st, &layout, &err_code, mem_ptr
+            , (char *)&init);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[2][1][3] = 5;
+            if (daa_grow(sizeof(long), 3, d, st, &layout, &err_code, mem_ptr, 4
+                , (char *)&init2) != (void *) array)
+            {
+                fprintf(stderr, "daa: error on daa_grow(). %s\n", daa_errs[err_code]);
+            }
+
+            fprintf(stderr, "daa_grow() dimension 0 = %lu\n", (unsigned long) d[0]);
+            fprintf(stderr, "array[ 2][ 1][ 3] = %ld\n", array[2][1][3]);
+            fprintf(stderr, "array[ 4][ 1][ 3] = %ld\n", array[4][1][3]);
+            fprintf(stderr, "daa_grow() to 5 = %s\n\n"
+                , daa_grow(sizeof(long), 3, d, st, &layout, &err_code, mem_ptr, 5
+                , NULL) == NULL ? daa_errs[err_code] : "no error");
+        }
+        free(mem_ptr);
+
+        err_code = 0;
+        d[0] = 2;
+        array = (long ***) daa_map_huge(sizeof(long), 3, d, st, &layout, &err_code
+            , (char *)&init, &map);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[2][1][3] = 5;
+            array = (long ***) daa_map_resize(sizeof(long), 3, d, st, &layout, &err_code
+                , (char *)&init2, 9, &map);
+        }
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on daa_map_resize(). %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            fprintf(stderr, "daa_map_resize() dimension 0 = %lu, cap0 = %lu\n"
+                , (unsigned long) d[0], (unsigned long) layout.cap0);
+            fprintf(stderr, "array[ 1][-1][ 0] = %ld\n", array[1][-1][0]);
+            fprintf(stderr, "array[ 2][ 1][ 3] = %ld\n", array[2][1][3]);
+            fprintf(stderr, "array[ 9][ 1][ 3] = %ld\n", array[9][1][3]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        daa_unmap(&map);
+
+        /* no capacity, a shrink stays in the mapping */
+        daa_layout nocap = {0, 0, 0};
+        size_t map_size;
+
+        d[0] = 6;
+        array = (long ***) daa_map_huge(sizeof(long), 3, d, st, &nocap, &err_code
+            , (char *)&init, &map);
+        map_size = map.map_size;
+        if (array != NULL)
+        {
+            array[3][1][3] = 5;
+            array = (long ***) daa_map_resize(sizeof(long), 3, d, st, &nocap, &err_code
+                , NULL, 3, &map);
+        }
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on daa_map_resize(). %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            fprintf(stderr, "cap0 0, daa_map_resize() 6 to %lu, cap0 = %lu, mapping %s\n"
+                , (unsigned long) d[0], (unsigned long) nocap.cap0
+                , map.map_size == map_size ? "unchanged" : "grown");
+            fprintf(stderr, "array[ 3][ 1][ 3] = %ld\n\n", array[3][1][3]);
+        }
+        daa_unmap(&map);
+
+        /* base relative, aligned to more than mremap() keeps */
+        daa_layout rel = {DAA_REL, 65536, 2};
+
+        d[0] = 2;
+        if (daa_map_huge(sizeof(long), 3, d, st, &rel, &err_code, (char *)&init
+            , &map) == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            daa_typed_view<long, 3>(map.base, d, st, rel, &err_code).at(2, 1, 3) = 5;
+            if (daa_map_resize(sizeof(long), 3, d, st, &rel, &err_code
+                , (char *)&init2, 5, &map) == NULL)
+            {
+                fprintf(stderr, "daa: error on daa_map_resize(). %s\n"
+                    , daa_errs[err_code]);
+            }
+            else
+            {
+                daa_typed_view<long, 3> grown(map.base, d, st, rel, &err_code);
+
+                fprintf(stderr, "DAA_REL align 65536, daa_map_resize() 2 to %lu, cap0 = %lu, base %s\n"
+                    , (unsigned long) d[0], (unsigned long) rel.cap0
+                    , (size_t) map.base % 65536 == 0 ? "aligned" : "not aligned");
+                fprintf(stderr, "array[ 2][ 1][ 3] = %ld\n", grown.at(2, 1, 3));
+                fprintf(stderr, "array[ 5][ 1][ 3] = %ld\n\n", grown.at(5, 1, 3));
+            }
+        }
+        daa_unmap(&map);
+    }
+
+    /*
+     * TEST 30
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+
+        size_t d[3] = {5, 4, 3}; /* dimensions */
+        ptrdiff_t st[3] = {0, 1, -1}; /* starting subscripts */
+        int init = 8;
+        int ***array; /* array pointer */
+        daa_layout layout = {DAA_PTRS_FIRST, 64, 0};
+
+        fprintf(stderr, "\nTEST 30");
+        fprintf(stderr, "\n    3 dimensional array of int, DAA_PTRS_FIRST layout, data aligned to 64");
+        fprintf(stderr, "\n        dimensions: 5, 4, 3");
+        fprintf(stderr, "\n        starting subscripts: 0, 1, -1");
+        fprintf(stderr, "\n        init: 8\n");
+        fprintf(stderr, "\n    the pointers come first, so the array pointer is the malloc() pointer");
+        fprintf(stderr, "\n    and is given to free() with no separate mem_ptr.  set");
+        fprintf(stderr, "\n    array[4][4][1] = 9\n\n");
+
+        asize = das(sizeof(int), 3, d, &layout, &err_code);
+        array = (int ***) daa(sizeof(int), 3, d, st, &layout, &err_code
+            , (char *)malloc(asize), (char *)&init);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[4][4][1] = 9;
+
+            fprintf(stderr, "pointers before the data = %s\n"
+                , (char *) &array[0][1][-1] > (char *) &array[4][4] ? "yes" : "no");
+            fprintf(stderr, "data 64 byte aligned = %s\n\n"
+                , (size_t) &array[0][1][-1] % 64 == 0 ? "yes" : "no");
+            fprintf(stderr, "array[ 0][ 1][-1] = %d\n", array[0][1][-1]);
+            fprintf(stderr, "array[ 4][ 4][ 1] = %d\n", array[4][4][1]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(array);
+    }
+
+    /*
+     * TEST 31
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr[2];
+
+        size_t d[3] = {3, 4, 5}; /* dimensions */
+        ptrdiff_t st[3] = {-1, 0, 2}; /* starting subscripts */
+        float init = 0.5f;
+        float ***array[2]; /* array pointers */
+        daa_plan plan;
+
+        fprintf(stderr, "\nTEST 31");
+        fprintf(stderr, "\n    3 dimensional array of float, daa_plan_init() and daa_plan_build()");
+        fprintf(stderr, "\n        dimensions: 3, 4, 5");
+        fprintf(stderr, "\n        starting subscripts: -1, 0, 2");
+        fprintf(stderr, "\n        init: 0.5\n");
+        fprintf(stderr, "\n    make one plan for the shape and build two arrays from it.  set");
+        fprintf(stderr, "\n    array0[1][3][6] = 1.5 and array1[1][3][6] = 2.5\n\n");
+
+        asize = daa_plan_init(sizeof(float), 3, d, st, NULL, &err_code, &plan);
+        mem_ptr[0] = (char *)malloc(asize);
+        mem_ptr[1] = (char *)malloc(asize);
+        array[0] = (float ***) daa_plan_build(&plan, &err_code, mem_ptr[0], (char *)&init);
+        array[1] = (float ***) daa_plan_build(&plan, &err_code, mem_ptr[1], (char *)&init);
+
+        if (asize == 0 || array[0] == NULL || array[1] == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            array[0][1][3][6] = 1.5f;
+            array[1][1][3][6] = 2.5f;
+
+            fprintf(stderr, "plan size = %lu, das() size = %lu\n", (unsigned long) asize
+                , (unsigned long) das(sizeof(float), 3, d, &err_code));
+            fprintf(stderr, "array0 pointers in its own block = %s\n\n"
+                , (char *) &array[0][1][3][6] > mem_ptr[0]
+                && (char *) &array[0][1][3][6] < mem_ptr[0] + asize ? "yes" : "no");
+            fprintf(stderr, "array0[-1][ 0][ 2] = %3.1f\n", array[0][-1][0][2]);
+            fprintf(stderr, "array0[ 1][ 3][ 6] = %3.1f\n", array[0][1][3][6]);
+            fprintf(stderr, "array1[-1][ 0][ 2] = %3.1f\n", array[1][-1][0][2]);
+            fprintf(stderr, "array1[ 1][ 3][ 6] = %3.1f\n", array[1][1][3][6]);
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+        free(mem_ptr[0]);
+        free(mem_ptr[1]);
+        daa_plan_free(&plan);
+    }
+
+    /*
+     * TEST 32
+     */
+    {
+        int err_code = 0;
+        int id;
+
+        size_t d[3] = {4, 3, 2}; /* dimensions */
+        ptrdiff_t st[3] = {1, 0, -1}; /* starting subscripts */
+        int init = 2;
+        int ***array[2]; /* array pointers */
+        daa_pool pool;
+        daa_pool_stats stats;
+
+        fprintf(stderr, "\nTEST 32");
+        fprintf(stderr, "\n    3 dimensional array of int, daa_pool recycled arrays");
+        fprintf(stderr, "\n        dimensions: 4, 3, 2");
+        fprintf(stderr, "\n        starting subscripts: 1, 0, -1");
+        fprintf(stderr, "\n        init: 2\n");
+        fprintf(stderr, "\n    get an array from a per thread cache, set array[4][2][0] = 3, put it");
+        fprintf(stderr, "\n    and get it again without init.  then 4 threads each get and put");
+        fprintf(stderr, "\n    1000 arrays through their own caches, and 4 threads 1000 arrays");
+        fprintf(stderr, "\n    straight from the pool\n\n");
+
+        id = pool.shape(sizeof(int), 3, d, st, NULL, &err_code);
+        if (id < 0)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            std::vector<std::thread> workers;
+
+            {
+                daa_pool_cache cache(pool);
+
+                array[0] = (int ***) cache.get(id, &err_code, (char *)&init);
+                array[0][4][2][0] = 3;
+                cache.put(id, array[0]);
+                array[1] = (int ***) cache.get(id, &err_code);
+
+                fprintf(stderr, "same block recycled = %s\n"
+                    , array[1] == array[0] ? "yes" : "no");
+                fprintf(stderr, "array[ 1][ 0][-1] = %d\n", array[1][1][0][-1]);
+                fprintf(stderr, "array[ 4][ 2][ 0] = %d\n", array[1][4][2][0]);
+                cache.put(id, array[1]);
+            }
+
+            for (int t=0 ; t<4 ; t++)
+            {
+                workers.push_back(std::thread([&pool, id, init]()
+                {
+                    int err = 0;
+                    daa_pool_cache cache(pool, 8);
+
+                    for (int k=0 ; k<1000 ; k++)
+                    {
+                        int ***a = (int ***) cache.get(id, &err, (char *)&init);
+
+                        a[4][2][0] += k;
+                        cache.put(id, a);
+                    }
+                }));
+            }
+            for (size_t t=0 ; t<workers.size() ; t++)
+            {
+                workers[t].join();
+            }
+
+            stats = pool.stats(id);
+            fprintf(stderr, "gets = %lu, at most one miss per thread = %s\n"
+                , (unsigned long) (stats.hits + stats.misses)
+                , stats.misses <= 4 ? "yes" : "no");
+            pool.trim();
+            fprintf(stderr, "blocks after trim() = %lu\n"
+                , (unsigned long) pool.stats(id).blocks);
+
+            /* a thread holds one array at a time, so 4 blocks serve them all */
+            workers.clear();
+            for (int t=0 ; t<4 ; t++)
+            {
+                workers.push_back(std::thread([&pool, id]()
+                {
+                    int err = 0;
+
+                    for (int k=0 ; k<1000 ; k++)
+                    {
+                        int ***a = (int ***) pool.get(id, &err);
+
+                        a[4][2][0] += k;
+                        pool.put(id, a);
+                    }
+                }));
+            }
+            for (size_t t=0 ; t<workers.size() ; t++)
+            {
+                workers[t].join();
+            }
+            fprintf(stderr, "pool gets = %lu, at most one miss per thread = %s\n"
+                , (unsigned long) (pool.stats(id).hits + pool.stats(id).misses
+                - stats.hits - stats.misses)
+                , pool.stats(id).misses - stats.misses <= 4 ? "yes" : "no");
+            fprintf(stderr, "err_code = %d\n\n", err_code);
+        }
+    }
+
+    /*
+     * TEST 33
+     */
+    {
+        int err_code = 0;
+        alignas(64) static char arena_buf[16384];
+
+        double init = 0.25;
+
+        fprintf(stderr, "\nTEST 33");
+        fprintf(stderr, "\n    3 dimensional arrays of double, daa_array with a daa_pmr allocator");
+        fprintf(stderr, "\n        dimensions: 6, 5, 4 and 3, 3, 3");
+        fprintf(stderr, "\n        starting subscripts: 0, 1, -1 and 0, 0, 0");
+        fprintf(stderr, "\n        init: 0.25\n");
+        fprintf(stderr, "\n    allocate two arrays, 64 byte aligned, from a monotonic_buffer_resource");
+        fprintf(stderr, "\n    over a 16 KiB buffer, which releases them both at once.  set");
+        fprintf(stderr, "\n    a[5][5][2] = 4.5\n\n");
+
+        {
+            std::pmr::monotonic_buffer_resource arena(arena_buf, sizeof(arena_buf)
+                , std::pmr::null_memory_resource());
+            daa_array<double, 3, daa_pmr> a({6, 5, 4}, {0, 1, -1}, daa_pmr(&arena), 64
+                , &init, &err_code);
+            daa_array<double, 3, daa_pmr> b({3, 3, 3}, {0, 0, 0}, daa_pmr(&arena), 64
+                , &init, &err_code);
+
+            if (!a || !b)
+            {
+                fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                    , daa_errs[err_code]);
+            }
+            else
+            {
+                a[5][5][2] = 4.5;
+
+                fprintf(stderr, "both in the arena = %s\n"
+                    , a.base() >= arena_buf && b.base() + b.size() <= arena_buf + sizeof(arena_buf)
+                    ? "yes" : "no");
+                fprintf(stderr, "data 64 byte aligned = %s\n\n"
+                    , (size_t) &a[0][1][-1] % 64 == 0 && (size_t) &b[0][0][0] % 64 == 0
+                    ? "yes" : "no");
+                fprintf(stderr, "a[ 0][ 1][-1] = %4.2f\n", a[0][1][-1]);
+                fprintf(stderr, "a[ 5][ 5][ 2] = %4.2f\n", a[5][5][2]);
+                fprintf(stderr, "b[ 2][ 2][ 2] = %4.2f\n", b[2][2][2]);
+                fprintf(stderr, "err_code = %d\n\n", err_code);
+            }
+        }
+    }
+
+    /*
+     * TEST 34
+     */
+    {
+        int err_code = 0;
+        static char arena_buf[8192]; /* the arena, no malloc() */
+        char *base[3];
+
+        size_t d[3] = {4, 4, 4}; /* dimensions */
+        size_t big[3] = {16, 16, 16}; /* dimensions of a refused array */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        short init = 7;
+        short ***array[3]; /* array pointers */
+        daa_arena arena;
+
+        fprintf(stderr, "\nTEST 34");
+        fprintf(stderr, "\n    3 dimensional arrays of short, daa_arena over a static buffer");
+        fprintf(stderr, "\n        dimensions: 4, 4, 4");
+        fprintf(stderr, "\n        starting subscripts: 0, 0, 0");
+        fprintf(stderr, "\n        init: 7\n");
+        fprintf(stderr, "\n    allocate three arrays from an 8 KiB static buffer, release the second");
+        fprintf(stderr, "\n    and allocate again, which reuses its block.  a 16, 16, 16 array does");
+        fprintf(stderr, "\n    not fit and is refused\n\n");
+
+        daa_arena_init(&arena, arena_buf, sizeof(arena_buf));
+        for (int k=0 ; k<3 ; k++)
+        {
+            array[k] = (short ***) daa_arena_daa(&arena, sizeof(short), 3, d, st, NULL
+                , &err_code, (char *)&init, &base[k]);
+        }
+
+        if (array[0] == NULL || array[1] == NULL || array[2] == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            char *old = base[1];
+
+            array[2][3][3][3] = 8;
+            daa_arena_free(&arena, base[1]);
+            array[1] = (short ***) daa_arena_daa(&arena, sizeof(short), 3, d, st, NULL
+                , &err_code, (char *)&init, &base[1]);
+
+            fprintf(stderr, "block reused = %s\n", base[1] == old ? "yes" : "no");
+            fprintf(stderr, "das() size = %lu, used = %lu, high water mark = %lu\n"
+                , (unsigned long) das(sizeof(short), 3, d, NULL, &err_code)
+                , (unsigned long) arena.used, (unsigned long) arena.high);
+            fprintf(stderr, "16, 16, 16 array = %s\n\n"
+                , daa_arena_daa(&arena, sizeof(short), 3, big, st, NULL, &err_code
+                , (char *)&init, &base[0]) == NULL ? daa_errs[err_code] : "allocated");
+            fprintf(stderr, "array1[ 0][ 0][ 0] = %d\n", array[1][0][0][0]);
+            fprintf(stderr, "array2[ 3][ 3][ 3] = %d\n\n", array[2][3][3][3]);
+        }
+    }
+
+    /*
+     * TEST 35
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {512, 64, 64}; /* dimensions */
+        size_t e[3] = {4, 4, 4}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        double init = 0;
+        int zero = 0;
+        double ***array; /* array pointer */
+        int ***iarray; /* array pointer */
+        daa_layout layout = {DAA_ZEROED, 0, 4};
+        daa_map map;
+        unsigned char vec[1024]; /* mincore() residency of 4 MiB of data */
+        size_t page = (size_t) sysconf(_SC_PAGESIZE);
+        size_t resident = 0;
+
+        fprintf(stderr, "\nTEST 35");
+        fprintf(stderr, "\n    3 dimensional arrays, zero init without touching the data, DAA_ZEROED");
+        fprintf(stderr, "\n        dimensions: 512, 64, 64 of double, 4, 4, 4 of int");
+        fprintf(stderr, "\n        starting subscripts: 0, 0, 0");
+        fprintf(stderr, "\n        init: 0\n");
+        fprintf(stderr, "\n    map the 16 MiB array with daa_map_huge() and count the resident pages");
+        fprintf(stderr, "\n    of the first 4 MiB of data.  then build the int array in calloc()");
+        fprintf(stderr, "\n    space, set array[3][3][3] = 5, shrink dimension 0 to 2 and grow it");
+        fprintf(stderr, "\n    back to 4 with daa_grow(), the vacated rows read as 0\n\n");
+
+        array = (double ***) daa_map_huge(sizeof(double), 3, d, st, NULL, &err_code
+            , (char *)&init, &map);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            char *first = (char *) &array[0][0][0];
+            size_t len = 4*1024*1024 / page;
+
+            first += (page - (size_t) first % page) % page;
+            if (len > sizeof(vec) || mincore(first, len*page, vec) != 0)
+            {
+                len = 0;
+            }
+            for (size_t k=0 ; k<len ; k++)
+            {
+                resident += vec[k] & 1;
+            }
+            fprintf(stderr, "resident data pages = %lu\n", (unsigned long) resident);
+            fprintf(stderr, "array[  0][ 0][ 0] = %g\n", array[0][0][0]);
+            fprintf(stderr, "array[511][63][63] = %g\n\n", array[511][63][63]);
+        }
+        daa_unmap(&map);
+
+        asize = das(sizeof(int), 3, e, &layout, &err_code);
+        mem_ptr = (char *)calloc(1, asize);
+        iarray = (int ***) daa(sizeof(int), 3, e, st, &layout, &err_code, mem_ptr
+            , (char *)&zero);
+
+        if (iarray == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            iarray[3][3][3] = 5;
+            daa_grow(sizeof(int), 3, e, st, &layout, &err_code, mem_ptr, 2, NULL);
+            daa_grow(sizeof(int), 3, e, st, &layout, &err_code, mem_ptr, 4
+                , (char *)&zero);
+
+            fprintf(stderr, "iarray[ 1][ 1][ 1] = %d\n", iarray[1][1][1]);
+            fprintf(stderr, "iarray[ 3][ 3][ 3] = %d\n\n", iarray[3][3][3]);
+        }
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 36
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *win_ptr;
+        char *even_ptr;
+
+        size_t d[3] = {12, 24, 4}; /* dimensions */
+        ptrdiff_t st[3] = {1, 1, 0}; /* starting subscripts */
+        ptrdiff_t lo[3] = {2, 5, 0}; /* the window */
+        size_t n[3] = {9, 16, 4};
+        ptrdiff_t elo[3] = {2, 1, 0}; /* every other plane from 2, at subscript 0 */
+        size_t en[3] = {6, 24, 4};
+        ptrdiff_t estep[3] = {2, 1, 1};
+        ptrdiff_t est[3] = {0, 1, 0};
+        int ***array; /* array pointer */
+        int ***win; /* view pointers */
+        int ***even;
+        daa_desc desc;
+        daa_desc wdesc;
+        daa_desc edesc;
+
+        fprintf(stderr, "\nTEST 36");
+        fprintf(stderr, "\n    3 dimensional array of int, views with dad_sub()/das_sub()/daa_sub()");
+        fprintf(stderr, "\n        dimensions: 12, 24, 4");
+        fprintf(stderr, "\n        starting subscripts: 1, 1, 0");
+        fprintf(stderr, "\n        init: array[i][j][k] = 10000*i + 100*j + k\n");
+        fprintf(stderr, "\n    a window [2..10][5..20][*] and every other plane from 2, at start");
+        fprintf(stderr, "\n    subscripts 0, 1, 0, share the array data.  a step in the last");
+        fprintf(stderr, "\n    dimension is refused by daa_sub()\n\n");
+
+        asize = das(sizeof(int), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (int ***) daa(sizeof(int), 3, d, st, &err_code, mem_ptr, NULL);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+            free(mem_ptr);
+        }
+        else
+        {
+            for (int i=1 ; i<=12 ; i++)
+            {
+                for (int j=1 ; j<=24 ; j++)
+                {
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[i][j][k] = 10000*i + 100*j + k;
+                    }
+                }
+            }
+
+            dad(sizeof(int), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+            dad_sub(&desc, lo, n, NULL, NULL, &err_code, &wdesc);
+            dad_sub(&desc, elo, en, estep, est, &err_code, &edesc);
+            win_ptr = (char *)malloc(das_sub(&wdesc, &err_code));
+            even_ptr = (char *)malloc(das_sub(&edesc, &err_code));
+            win = (int ***) daa_sub(&wdesc, &err_code, win_ptr);
+            even = (int ***) daa_sub(&edesc, &err_code, even_ptr);
+
+            fprintf(stderr, "window table bytes = %lu, data bytes = %lu\n"
+                , (unsigned long) das_sub(&wdesc, &err_code)
+                , (unsigned long) (9 * 16 * 4 * sizeof(int)));
+            fprintf(stderr, "win[ 2][ 5][ 0] = %d\n", win[2][5][0]);
+            fprintf(stderr, "win[10][20][ 3] = %d\n", win[10][20][3]);
+            fprintf(stderr, "even[ 0][ 1][ 0] = %d\n", even[0][1][0]);
+            fprintf(stderr, "even[ 5][24][ 3] = %d\n", even[5][24][3]);
+
+            win[3][6][1] = -1;
+            fprintf(stderr, "win[3][6][1] = -1, array[ 3][ 6][ 1] = %d\n", array[3][6][1]);
+
+            estep[2] = 2;
+            en[2] = 2;
+            dad_sub(&desc, elo, en, estep, est, &err_code, &edesc);
+            fprintf(stderr, "last dimension step 2 = %s\n"
+                , daa_sub(&edesc, &err_code, even_ptr) == NULL ? daa_errs[err_code]
+                : "no error");
+            lo[0] = 5;
+            fprintf(stderr, "window [5..13] = %s\n\n"
+                , dad_sub(&desc, lo, n, NULL, NULL, &err_code, &wdesc) == NULL
+                ? daa_errs[err_code] : "no error");
+
+            free(even_ptr);
+            free(win_ptr);
+            free(mem_ptr);
+        }
+    }
+
+    /*
+     * TEST 37
+     */
+    {
+        int err_code = 0;
+        char *ptr_area;
+
+        static int frame[2*3*4]; /* a received frame, dense */
+        int *image; /* 4 rows of 5 pixels, each row padded to 32 bytes */
+        size_t d[3] = {2, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {1, 1, 1}; /* starting subscripts */
+        size_t e[2] = {4, 5}; /* dimensions */
+        ptrdiff_t est[2] = {0, 0}; /* starting subscripts */
+        int ***array; /* array pointers */
+        int **img;
+        daa_layout rows = {DAA_PAD_ROWS, 32, 0};
+
+        fprintf(stderr, "\nTEST 37");
+        fprintf(stderr, "\n    arrays of int over data the caller has, das_adopt()/daa_adopt()");
+        fprintf(stderr, "\n        dimensions: 2, 3, 4 and 4, 5 with rows padded to 32 bytes");
+        fprintf(stderr, "\n        starting subscripts: 1, 1, 1 and 0, 0");
+        fprintf(stderr, "\n        init: frame[i] = i, image[i] = i\n");
+        fprintf(stderr, "\n    index a dense frame and a padded image in place, the pointers in a");
+        fprintf(stderr, "\n    separate area.  set array[2][3][4] = -1 and img[3][4] = -1\n\n");
+
+        for (int i=0 ; i<2*3*4 ; i++)
+        {
+            frame[i] = i;
+        }
+        image = (int *)daa_alloc(4*8*sizeof(int), 32);
+        for (int i=0 ; i<4*8 ; i++)
+        {
+            image[i] = i;
+        }
+
+        ptr_area = (char *)malloc(das_adopt(sizeof(int), 3, d, NULL, &err_code));
+        array = (int ***) daa_adopt(sizeof(int), 3, d, st, NULL, &err_code
+            , (char *)frame, ptr_area);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on daa_adopt(). %s\n", daa_errs[err_code]);
+        }
+        else
+        {
+            fprintf(stderr, "pointer area bytes = %lu, data bytes = %lu\n"
+                , (unsigned long) das_adopt(sizeof(int), 3, d, NULL, &err_code)
+                , (unsigned long) sizeof(frame));
+            fprintf(stderr, "array[ 1][ 1][ 1] = %d\n", array[1][1][1]);
+            fprintf(stderr, "array[ 2][ 1][ 3] = %d\n", array[2][1][3]);
+            array[2][3][4] = -1;
+            fprintf(stderr, "frame[23] = %d\n\n", frame[23]);
+        }
+        free(ptr_area);
+
+        ptr_area = (char *)malloc(das_adopt(sizeof(int), 2, e, &rows, &err_code));
+        img = (int **) daa_adopt(sizeof(int), 2, e, est, &rows, &err_code
+            , (char *)image, ptr_area);
+
+        if (img == NULL)
+        {
+            fprintf(stderr, "daa: error on daa_adopt(). %s\n", daa_errs[err_code]);
+        }
+        else
+        {
+            fprintf(stderr, "img[ 1][ 0] = %d\n", img[1][0]);
+            fprintf(stderr, "img[ 3][ 2] = %d\n", img[3][2]);
+            img[3][4] = -1;
+            fprintf(stderr, "image[28] = %d\n", image[28]);
+            fprintf(stderr, "misaligned data = %s\n\n"
+                , daa_adopt(sizeof(int), 2, e, est, &rows, &err_code, (char *)&image[1]
+                , ptr_area) == NULL ? daa_errs[err_code] : "no error");
+        }
+        free(ptr_area);
+        daa_free(image);
+    }
+
+    /*
+     * TEST 38
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {2, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        ptrdiff_t fst[3] = {1, 1, 1}; /* starting subscripts of the mapped array */
+        ptrdiff_t lo[3] = {1, 0, 0}; /* plane 1 */
+        size_t n[3] = {1, 3, 4};
+        double ***array; /* array pointers */
+        double ***farray;
+        double *raw;
+        daa_desc desc;
+        daa_file file;
+
+        fprintf(stderr, "\nTEST 38");
+        fprintf(stderr, "\n    3 dimensional array of double, daa_npy_write()/daa_npy_map() and");
+        fprintf(stderr, "\n    daa_raw_write()/daa_raw_map()");
+        fprintf(stderr, "\n        dimensions: 2, 3, 4");
+        fprintf(stderr, "\n        starting subscripts: 0, 0, 0, mapped 1, 1, 1");
+        fprintf(stderr, "\n        init: array[i][j][k] = 100*i + 10*j + k\n");
+        fprintf(stderr, "\n    write the array as daa_test.npy, map it read only at start subscripts");
+        fprintf(stderr, "\n    1, 1, 1, then write plane 1 as the raw file daa_test.raw and map it\n\n");
+
+        asize = das(sizeof(double), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (double ***) daa(sizeof(double), 3, d, st, &err_code, mem_ptr, NULL);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (int i=0 ; i<2 ; i++)
+            {
+                for (int j=0 ; j<3 ; j++)
+                {
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[i][j][k] = 100*i + 10*j + k;
+                    }
+                }
+            }
+            dad(sizeof(double), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+
+            if (daa_npy_write("daa_test.npy", "<f8", &desc, &err_code) != 0 ||
+                (farray = (double ***) daa_npy_map("daa_test.npy", fst, DAA_FILE_READ
+                , &err_code, &file)) == NULL)
+            {
+                fprintf(stderr, "daa: error on .npy file. %s\n", daa_errs[err_code]);
+            }
+            else
+            {
+                fprintf(stderr, "descr = %s, shape = %lu, %lu, %lu, data offset = %lu\n"
+                    , file.descr, (unsigned long) file.dim[0], (unsigned long) file.dim[1]
+                    , (unsigned long) file.dim[2], (unsigned long) (file.data - file.map));
+                fprintf(stderr, "farray[ 1][ 1][ 1] = %g\n", farray[1][1][1]);
+                fprintf(stderr, "farray[ 2][ 3][ 4] = %g\n\n", farray[2][3][4]);
+            }
+            daa_file_unmap(&file);
+
+            dad_sub(&desc, lo, n, NULL, NULL, &err_code, &desc);
+            if (daa_raw_write("daa_test.raw", &desc, &err_code) != 0 ||
+                (raw = (double *) daa_raw_map("daa_test.raw", 4 * sizeof(double)
+                , sizeof(double), 1, &n[2], st, DAA_FILE_READ, &err_code
+                , &file)) == NULL)
+            {
+                fprintf(stderr, "daa: error on raw file. %s\n", daa_errs[err_code]);
+            }
+            else
+            {
+                fprintf(stderr, "raw file row 1 = %g %g %g %g\n", raw[0], raw[1], raw[2]
+                    , raw[3]);
+                fprintf(stderr, "2, 3, 4 array from the 12 double file = %s\n\n"
+                    , daa_raw_map("daa_test.raw", 0, sizeof(double), 3, d, st
+                    , DAA_FILE_READ, &err_code, &file) == NULL ? daa_errs[err_code]
+                    : "no error");
+            }
+            daa_file_unmap(&file);
+            remove("daa_test.npy");
+            remove("daa_test.raw");
+        }
+        free(mem_ptr);
+    }
+
+    /*
+     * TEST 39
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *load_ptr;
+        FILE *fp;
+
+        size_t d[3] = {3, 4, 5}; /* dimensions */
+        ptrdiff_t st[3] = {-1, 0, 1}; /* starting subscripts */
+        int ***array; /* array pointers */
+        int ***larray;
+        daa_layout layout = {DAA_PAD_ROWS, 32, 0};
+        daa_head head;
+
+        fprintf(stderr, "\nTEST 39");
+        fprintf(stderr, "\n    3 dimensional array of int, rows padded to 32 bytes, daa_save(),");
+        fprintf(stderr, "\n    das_load() and daa_load()");
+        fprintf(stderr, "\n        dimensions: 3, 4, 5");
+        fprintf(stderr, "\n        starting subscripts: -1, 0, 1");
+        fprintf(stderr, "\n        init: array[i][j][k] = 100*i + 10*j + k\n");
+        fprintf(stderr, "\n    save the array to daa_test.daa, read the header and load it into a");
+        fprintf(stderr, "\n    new block.  then change one data byte of the file and load again\n\n");
+
+        asize = das(sizeof(int), 3, d, &layout, &err_code);
+        mem_ptr = (char *)daa_alloc(asize, 32);
+        array = (int ***) daa(sizeof(int), 3, d, st, &layout, &err_code, mem_ptr, NULL);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (int i=-1 ; i<2 ; i++)
+            {
+                for (int j=0 ; j<4 ; j++)
+                {
+                    for (int k=1 ; k<6 ; k++)
+                    {
+                        array[i][j][k] = 100*i + 10*j + k;
+                    }
+                }
+            }
+
+            if (daa_save("daa_test.daa", sizeof(int), 3, d, st, &layout, &err_code
+                , mem_ptr) != 0 || (asize = das_load("daa_test.daa", &head, &err_code)) == 0)
+            {
+                fprintf(stderr, "daa: error on daa_save()/das_load(). %s\n"
+                    , daa_errs[err_code]);
+            }
+            else
+            {
+                fprintf(stderr, "header bytes = %lu, data bytes = %lu\n"
+                    , (unsigned long) head.head_len, (unsigned long) head.data_bytes);
+                fprintf(stderr, "dimensions = %lu, %lu, %lu, starting subscripts = %ld, %ld, %ld\n"
+                    , (unsigned long) head.dim[0], (unsigned long) head.dim[1]
+                    , (unsigned long) head.dim[2], (long) head.st[0], (long) head.st[1]
+                    , (long) head.st[2]);
+                fprintf(stderr, "layout flags = %u, align = %lu\n", head.layout.flags
+                    , (unsigned long) head.layout.align);
+
+                load_ptr = (char *)daa_alloc(asize, 32);
+                larray = (int ***) daa_load("daa_test.daa", &head, &err_code, load_ptr);
+                if (larray == NULL)
+                {
+                    fprintf(stderr, "daa: error on daa_load(). %s\n", daa_errs[err_code]);
+                }
+                else
+                {
+                    fprintf(stderr, "larray[-1][ 0][ 1] = %d\n", larray[-1][0][1]);
+                    fprintf(stderr, "larray[ 1][ 3][ 5] = %d\n", larray[1][3][5]);
+                }
+
+                fp = fopen("daa_test.daa", "r+b");
+                fseek(fp, (long) head.head_len + 7, SEEK_SET);
+                fputc(0x55, fp);
+                fclose(fp);
+                fprintf(stderr, "changed file = %s\n\n"
+                    , daa_load("daa_test.daa", &head, &err_code, load_ptr) == NULL
+                    ? daa_errs[err_code] : "no error");
+                daa_free(load_ptr);
+            }
+            remove("daa_test.daa");
+        }
+        daa_free(mem_ptr);
+    }
+
+    /*
+     * TEST 40
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+
+        size_t d[3] = {10, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {1, 0, 0}; /* starting subscripts */
+        int ***array; /* array pointers */
+        int ***slab;
+        daa_desc desc;
+        daa_slabs slabs;
+        long sum = 0;
+
+        fprintf(stderr, "\nTEST 40");
+        fprintf(stderr, "\n    3 dimensional array of int out of core, daa_slabs_open()/daa_slabs_get()");
+        fprintf(stderr, "\n        dimensions: 10, 3, 4");
+        fprintf(stderr, "\n        starting subscripts: 1, 0, 0");
+        fprintf(stderr, "\n        init: array[i][j][k] = 100*i + 10*j + k\n");
+        fprintf(stderr, "\n    write the array to daa_test.raw and sweep it in slabs of 3 elements");
+        fprintf(stderr, "\n    of dimension 0, at most 2 resident, writes going to the file.  set");
+        fprintf(stderr, "\n    slab[4][2][3] = -1, then sweep again read only\n\n");
+
+        asize = das(sizeof(int), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        array = (int ***) daa(sizeof(int), 3, d, st, &err_code, mem_ptr, NULL);
+
+        if (array == NULL)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (int i=1 ; i<=10 ; i++)
+            {
+                for (int j=0 ; j<3 ; j++)
+                {
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[i][j][k] = 100*i + 10*j + k;
+                    }
+                }
+            }
+            dad(sizeof(int), 3, d, st, NULL, &err_code, mem_ptr, &desc);
+            daa_raw_write("daa_test.raw", &desc, &err_code);
+
+            for (int mode=DAA_FILE_WRITE ; mode>=DAA_FILE_READ ; mode-=2)
+            {
+                if (daa_slabs_open("daa_test.raw", 0, sizeof(int), 3, d, st, 3, 2, mode
+                    , &err_code, &slabs) != 0)
+                {
+                    fprintf(stderr, "daa: error on daa_slabs_open(). %s\n"
+                        , daa_errs[err_code]);
+                }
+                else
+                {
+                    sum = 0;
+                    for (int i=1 ; i<=10 ; i++)
+                    {
+                        slab = (int ***) daa_slabs_get(&slabs, i, &err_code);
+                        for (int j=0 ; j<3 ; j++)
+                        {
+                            for (int k=0 ; k<4 ; k++)
+                            {
+                                sum += slab[i][j][k];
+                            }
+                        }
+                    }
+                    slab = (int ***) daa_slabs_get(&slabs, 4, &err_code);
+                    fprintf(stderr, "%s sum = %ld, slab[ 4][ 2][ 3] = %d, loads = %lu, hits = %lu\n"
+                        , mode == DAA_FILE_WRITE ? "write" : "read ", sum, slab[4][2][3]
+                        , (unsigned long) slabs.loads, (unsigned long) slabs.hits);
+                    if (mode == DAA_FILE_WRITE)
+                    {
+                        slab[4][2][3] = -1;
+                    }
+                }
+                daa_slabs_close(&slabs);
+            }
+            fprintf(stderr, "daa_slabs_get(0) = %s\n\n", daa_slabs_open("daa_test.raw", 0
+                , sizeof(int), 3, d, st, 3, 2, DAA_FILE_READ, &err_code, &slabs) == 0
+                && daa_slabs_get(&slabs, 0, &err_code) == NULL ? daa_errs[err_code]
+                : "no error");
+            daa_slabs_close(&slabs);
+            remove("daa_test.raw");
+        }
+        free(mem_ptr);
+    }
+    /*
+     * TEST 41
+     */
+    {
+        int err_code = 0;
+        size_t asize = 0;
+        char *mem_ptr;
+        char *load_ptr;
+
+        size_t d[3] = {8, 3, 4}; /* dimensions */
+        ptrdiff_t st[3] = {0, 0, 0}; /* starting subscripts */
+        int ***array; /* array pointers */
+        int ***load;
+        daa_dirty dirty = {};
+        daa_head head;
+        pid_t pid;
+
+        fprintf(stderr, "\nTEST 41");
+        fprintf(stderr, "\n    3 dimensional array of int checkpoints, daa_checkpoint()/daa_dirty_set()");
+        fprintf(stderr, "\n        dimensions: 8, 3, 4");
+        fprintf(stderr, "\n        starting subscripts: 0, 0, 0");
+        fprintf(stderr, "\n        init: array[i][j][k] = 100*i + 10*j + k\n");
+        fprintf(stderr, "\n    checkpoint all of the array to daa_test.ckpt, set array[2][1][3] = -1");
+        fprintf(stderr, "\n    and array[5][0][k] = -2, tracked by innermost row, and checkpoint all");
+        fprintf(stderr, "\n    of it again, to the other file of the pair.  set array[0][0][0] = -3");
+        fprintf(stderr, "\n    while the checkpoint is written, then checkpoint the rows changed by");
+        fprintf(stderr, "\n    the last two.  set array[7][2][k] = -4 and checkpoint to a");
+        fprintf(stderr, "\n    missing directory, which fails, set array[6][0][1] = -5 and checkpoint");
+        fprintf(stderr, "\n    to daa_test.ckpt, then to a new file daa_test2.ckpt.  load each");
+        fprintf(stderr, "\n    checkpoint and print the changes.  then set array[1][0][0] = -6 and");
+        fprintf(stderr, "\n    array[7][1][0] = -7, checkpoint to daa_test2.ckpt, set them to -8");
+        fprintf(stderr, "\n    and -9 and checkpoint with a file size limit that kills the child");
+        fprintf(stderr, "\n    between the two rows, load the last checkpoint, and checkpoint again\n\n");
+
+        asize = das(sizeof(int), 3, d, &err_code);
+        mem_ptr = (char *)malloc(asize);
+        load_ptr = (char *)malloc(asize);
+        array = (int ***) daa(sizeof(int), 3, d, st, &err_code, mem_ptr, NULL);
+
+        if (array == NULL || daa_dirty_init(sizeof(int), 3, d, NULL, &err_code, mem_ptr, 1
+            , &dirty) != 0)
+        {
+            fprintf(stderr, "daa: error on dynamic allocation. %s\n"
+                , daa_errs[err_code]);
+        }
+        else
+        {
+            for (int i=0 ; i<8 ; i++)
+            {
+                for (int j=0 ; j<3 ; j++)
+                {
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[i][j][k] = 100*i + 10*j + k;
+                    }
+                }
+            }
+
+            for (int c=0 ; c<6 ; c++)
+            {
+                const char *path = (c == 3) ? "no_such_dir/daa_test.ckpt"
+                    : (c == 5) ? "daa_test2.ckpt" : "daa_test.ckpt";
+
+                if (c == 1)
+                {
+                    array[2][1][3] = -1;
+                    daa_dirty_set(&dirty, &array[2][1][3], sizeof(int));
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[5][0][k] = -2;
+                    }
+                    daa_dirty_set(&dirty, &array[5][0][0], 4 * sizeof(int));
+                }
+                if (c == 3)
+                {
+                    for (int k=0 ; k<4 ; k++)
+                    {
+                        array[7][2][k] = -4;
+                    }
+                    daa_dirty_set(&dirty, &array[7][2][0], 4 * sizeof(int));
+                }
+                if (c == 4)
+                {
+                    array[6][0][1] = -5;
+                    daa_dirty_set(&dirty, &array[6][0][1], sizeof(int));
+                }
+
+                pid = daa_checkpoint(path, sizeof(int), 3, d, st, NULL, &err_code
+                    , mem_ptr, &dirty);
+                if (c == 1)
+                {
+                    array[0][0][0] = -3;
+                    daa_dirty_set(&dirty, &array[0][0][0], sizeof(int));
+                }
+                if (pid < 0 || daa_checkpoint_wait(pid, &dirty, &err_code) != 0)
+                {
+                    fprintf(stderr, "checkpoint %d, %s\n", c, daa_errs[err_code]);
+                    continue;
+                }
+
+                load = NULL;
+                if (das_load(path, &head, &err_code) == asize)
+                {
+                    load = (int ***) daa_load(path, &head, &err_code, load_ptr);
+                }
+                if (load == NULL)
+                {
+                    fprintf(stderr, "daa: error on daa_load(). %s\n"
+                        , daa_errs[err_code]);
+                    break;
+                }
+                fprintf(stderr, "checkpoint %d, data bytes written = %3lu, [0][0][0] = %2d"
+                    ", [2][1][3] = %3d, [5][0][2] = %3d, [6][0][1] = %3d, [7][2][1] = %3d\n"
+                    , c, (unsigned long) dirty.written, load[0][0][0], load[2][1][3]
+                    , load[5][0][2], load[6][0][1], load[7][2][1]);
+            }
+
+            struct rlimit fsize;
+            struct rlimit core;
+            struct rlimit stop;
+            struct stat sb;
+
+            array[1][0][0] = -6;
+            array[7][1][0] = -7;
+            daa_dirty_set(&dirty, &array[1][0][0], sizeof(int));
+            daa_dirty_set(&dirty, &array[7][1][0], sizeof(int));
+            for (int c=6 ; c<9 ; c++)
+            {
+                if (c == 7)
+                {
+                    array[1][0][0] = -8;
+                    array[7][1][0] = -9;
+                    daa_dirty_set(&dirty, &array[1][0][0], sizeof(int));
+                    daa_dirty_set(&dirty, &array[7][1][0], sizeof(int));
+
+                    /* the child gets SIGXFSZ writing row [7][1], after row [1][0] */
+                    stat("daa_test2.ckpt", &sb);
+                    getrlimit(RLIMIT_FSIZE, &fsize);
+                    getrlimit(RLIMIT_CORE, &core);
+                    stop = fsize;
+                    stop.rlim_cur = (rlim_t) sb.st_size - (8*3 - (7*3 + 1)) * 4 * sizeof(int);
+                    setrlimit(RLIMIT_FSIZE, &stop);
+                    stop = core;
+                    stop.rlim_cur = 0;
+                    setrlimit(RLIMIT_CORE, &stop);
+                }
+                pid = daa_checkpoint("daa_test2.ckpt", sizeof(int), 3, d, st, NULL, &err_code
+                    , mem_ptr, &dirty);
+                if (c == 7)
+                {
+                    setrlimit(RLIMIT_FSIZE, &fsize);
+                    setrlimit(RLIMIT_CORE, &core);
+                }
+                if (pid < 0 || daa_checkpoint_wait(pid, &dirty, &err_code) != 0)
+                {
+                    fprintf(stderr, "checkpoint %d, %s\n", c, daa_errs[err_code]);
+                }
+
+                load = NULL;
+                if (das_load("daa_test2.ckpt", &head, &err_code) == asize)
+                {
+                    load = (int ***) daa_load("daa_test2.ckpt", &head, &err_code, load_ptr);
+                }
+                if (load == NULL)
+                {
+                    fprintf(stderr, "daa: error on daa_load(). %s\n"
+                        , daa_errs[err_code]);
+                    break;
+                }
+                fprintf(stderr, "checkpoint %d, data bytes written = %3lu, loaded [1][0][0] = %2d"
+                    ", [7][1][0] = %2d\n", c, (unsigned long) dirty.written, load[1][0][0]
+                    , load[7][1][0]);
+            }
+            fprintf(stderr, "\n");
+            remove("daa_test.ckpt");
+            remove("daa_test.ckpt.0");
+            remove("daa_test.ckpt.1");
+            remove("daa_test2.ckpt");
+            remove("daa_test2.ckpt.0");
+            remove("daa_test2.ckpt.1");
+        }
+        daa_dirty_free(&dirty);
+        free(load_ptr);
+        free(mem_ptr);
+    }
 }
 